@@ -7,7 +7,7 @@ echo Getting flags...
 for /f "delims=" %%i in ('pkg-config --cflags --libs gtk+-3.0') do set GTK_FLAGS=%%i
 
 echo Compiling...
-gcc -o sorter.exe src/main.c src/gui/full_window.c src/gui/tab_sort.c src/gui/tab_list.c src/gui/tab_tree.c src/gui/tab_graph.c src/gui/gui_utils.c src/backend/sort.c src/backend/linked_list.c src/backend/tree.c src/backend/graph.c -Iinclude -Wall -g %GTK_FLAGS%
+gcc -o sorter.exe src/main.c src/gui/full_window.c src/gui/tab_sort.c src/gui/tab_list.c src/gui/tab_tree.c src/gui/tab_graph.c src/gui/gui_utils.c src/gui/data_view.c src/backend/sort.c src/backend/linked_list.c src/backend/tree.c src/backend/graph.c src/backend/sort_generic.c src/backend/sort_typed.c src/backend/sort_parallel.c src/backend/sort_network.c src/backend/sort_string.c src/backend/sort_external.c src/backend/benchmark.c src/backend/perf_counters.c src/backend/distributions.c src/backend/string_arena.c src/backend/sort_trace.c src/backend/num_format.c src/backend/array_file.c src/backend/csv_stream.c -Iinclude -Wall -g -pthread %GTK_FLAGS%
 
 if %errorlevel% neq 0 (
     echo Compilation FAILED.
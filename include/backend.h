@@ -1,12 +1,16 @@
 #ifndef BACKEND_H
 #define BACKEND_H
 
+#include <stdatomic.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 // Structure to track sorting statistics
 typedef struct {
   unsigned long comparisons;
   unsigned long assignments;
+  unsigned long avoided; // Prefix sort: comparisons that needed no strcmp
 } SortStats;
 
 // Array structure (optional, but good for encapsulation)
@@ -17,7 +21,7 @@ typedef struct {
 
 // Array Utils
 void generate_array(int *arr, size_t n,
-                    int type); // 0=Random, 1=Sorted, 2=Reversed
+                    int type); // Distribution, values in 0..99
 
 // Sorting Algorithms
 void sort_bubble(int *arr, size_t n, SortStats *stats);
@@ -25,7 +29,30 @@ void sort_insertion(int *arr, size_t n, SortStats *stats);
 void sort_shell(int *arr, size_t n, SortStats *stats);
 void sort_quick(int *arr, size_t n, SortStats *stats);
 
-void sort_quick(int *arr, size_t n, SortStats *stats);
+// Non-comparison sorts (LSD radix, 8 bits per pass, O(n) extra memory;
+// introsort when that memory is not available). The _clean versions of
+// these and of the counting and network kernels below leave stats alone.
+void sort_radix_int(int *arr, size_t n, SortStats *stats);
+void sort_radix_double(double *arr, size_t n, SortStats *stats);
+void sort_radix_int_clean(int *arr, size_t n, SortStats *stats);
+void sort_radix_double_clean(double *arr, size_t n, SortStats *stats);
+
+// Counting sort for small key domains. The int version pre-scans min/max and
+// returns 0 (array untouched) when the range is too wide to histogram.
+int sort_counting_int(int *arr, size_t n, SortStats *stats);
+void sort_counting_char(char *arr, size_t n, SortStats *stats);
+int sort_counting_int_clean(int *arr, size_t n, SortStats *stats);
+void sort_counting_char_clean(char *arr, size_t n, SortStats *stats);
+
+// Branch-free sorting networks for blocks of at most SORT_NETWORK_MAX values
+// (introsort base case). AVX2 is detected at run time; without it they fall
+// back to insertion sort.
+#define SORT_NETWORK_MAX 64
+int sort_network_available(void);
+void sort_network_int(int *arr, size_t n, SortStats *stats);
+void sort_network_double(double *arr, size_t n, SortStats *stats);
+void sort_network_int_clean(int *arr, size_t n, SortStats *stats);
+void sort_network_double_clean(double *arr, size_t n, SortStats *stats);
 
 // --- Linked Lists (Generic) ---
 
@@ -41,6 +68,438 @@ typedef enum {
 // Placeholder for comparison function pointer
 typedef int (*CompareFunc)(const void *, const void *);
 
+// --- Array Sorting (Generic / Typed) ---
+
+// Generic sorts: any element size, ordered through a CompareFunc.
+// Kept for TYPE_CUSTOM; built-in types go through get_sort_kernel.
+void sort_bubble_gen(void *base, size_t n, size_t size, CompareFunc cmp,
+                     SortStats *stats);
+void sort_insertion_gen(void *base, size_t n, size_t size, CompareFunc cmp,
+                        SortStats *stats);
+void sort_shell_gen(void *base, size_t n, size_t size, CompareFunc cmp,
+                    SortStats *stats);
+void sort_quick_gen(void *base, size_t n, size_t size, CompareFunc cmp,
+                    SortStats *stats);
+// Same kernels with the SortStats counting compiled out (stats is ignored),
+// for timing
+void sort_bubble_gen_clean(void *base, size_t n, size_t size, CompareFunc cmp,
+                           SortStats *stats);
+void sort_insertion_gen_clean(void *base, size_t n, size_t size,
+                              CompareFunc cmp, SortStats *stats);
+void sort_shell_gen_clean(void *base, size_t n, size_t size, CompareFunc cmp,
+                          SortStats *stats);
+void sort_quick_gen_clean(void *base, size_t n, size_t size, CompareFunc cmp,
+                          SortStats *stats);
+// Selection, see SelectOp (plus _clean builds without counting)
+void select_nth_gen(void *base, size_t n, size_t size, size_t k,
+                    CompareFunc cmp, SortStats *stats);
+void partial_sort_gen(void *base, size_t n, size_t size, size_t k,
+                      CompareFunc cmp, SortStats *stats);
+void top_k_gen(void *base, size_t n, size_t size, size_t k, CompareFunc cmp,
+               SortStats *stats);
+void select_nth_gen_clean(void *base, size_t n, size_t size, size_t k,
+                          CompareFunc cmp, SortStats *stats);
+void partial_sort_gen_clean(void *base, size_t n, size_t size, size_t k,
+                            CompareFunc cmp, SortStats *stats);
+void top_k_gen_clean(void *base, size_t n, size_t size, size_t k,
+                     CompareFunc cmp, SortStats *stats);
+
+// Algorithm ids, in the order of the sort tab buttons and benchmark series
+typedef enum {
+  ALGO_BUBBLE,
+  ALGO_INSERTION,
+  ALGO_SHELL,
+  ALGO_QUICK,
+  ALGO_RADIX,
+  ALGO_PAR_QUICK,
+  ALGO_PAR_MERGE,
+  ALGO_MULTIKEY,
+  ALGO_NATURAL,
+  ALGO_PREFIX, // Strings only, see sort_prefix_str
+  ALGO_COUNT
+} SortAlgo;
+
+typedef void (*SortKernel)(void *base, size_t n, SortStats *stats);
+
+// Per-type building blocks, so the parallel drivers stay type-agnostic
+typedef struct {
+  size_t size; // Element size in bytes
+  // Partitions [lo, hi) and returns the pivot's final index
+  size_t (*partition)(void *base, size_t lo, size_t hi, SortStats *stats);
+  SortKernel sort; // Fastest sequential kernel
+  void (*merge)(const void *a, size_t na, const void *b, size_t nb, void *out,
+                SortStats *stats);
+  size_t (*lower_bound)(const void *run, size_t n, const void *key);
+  size_t (*upper_bound)(const void *run, size_t n, const void *key);
+} SortOps;
+
+extern const SortOps sort_ops_int;
+extern const SortOps sort_ops_double;
+extern const SortOps sort_ops_char;
+extern const SortOps sort_ops_str;
+
+// --- Parallel Sorting (sort_parallel.c) ---
+// threads <= 0 uses every online core; ranges of at most cutoff elements are
+// sorted sequentially. Per-thread stats are summed into *stats.
+void sort_parallel_config(int threads, size_t cutoff);
+int sort_parallel_threads(void);
+size_t sort_parallel_cutoff(void);
+void sort_parallel_quick(void *base, size_t n, const SortOps *ops,
+                         SortStats *stats);
+void sort_parallel_merge(void *base, size_t n, const SortOps *ops,
+                         SortStats *stats);
+
+// --- String Sorting (sort_string.c) ---
+// Multikey (three-way radix) quicksort, MSD radix pass on large partitions.
+// Compares byte by byte from the current depth instead of calling strcmp.
+void sort_multikey_str(char **arr, size_t n, SortStats *stats);
+void sort_multikey_str_clean(char **arr, size_t n, SortStats *stats);
+// Introsort on cached 8-byte big-endian prefixes, strcmp only on prefix
+// ties; stats->avoided counts the comparisons the prefixes settled.
+void sort_prefix_str(char **arr, size_t n, SortStats *stats);
+void sort_prefix_str_clean(char **arr, size_t n, SortStats *stats);
+
+// --- External Sorting (sort_external.c) ---
+// Called with the fraction done, in [0, 1]
+typedef void (*SortProgress)(double fraction, void *user);
+
+// Sorts a file in the sort tab's format (DataType on the first line, then
+// comma-separated values) into out_path, holding at most about mem_limit
+// bytes of data in memory; sorted runs are spilled to temporary files and
+// k-way merged. Returns 0, or -1 on I/O or format error.
+int sort_external_file(const char *in_path, const char *out_path,
+                       size_t mem_limit, SortProgress progress, void *user,
+                       SortStats *stats);
+
+// --- String Arena (string_arena.c) ---
+// Strings carved from large blocks and released together: one malloc per
+// block instead of one per string.
+typedef struct ArenaBlock ArenaBlock;
+typedef struct {
+  ArenaBlock *head;
+} StringArena;
+
+void string_arena_init(StringArena *a);
+char *string_arena_alloc(StringArena *a, size_t bytes); // NULL when OOM
+char *string_arena_dup(StringArena *a, const char *s);
+void string_arena_free(StringArena *a); // Every string at once, reusable
+
+// --- Input Distributions (distributions.c) ---
+typedef enum {
+  DIST_RANDOM,
+  DIST_SORTED,
+  DIST_REVERSED,
+  DIST_FEW_UNIQUE,    // `unique` distinct values
+  DIST_ORGAN_PIPE,    // Ascending then descending
+  DIST_SAWTOOTH,      // Ascending ramps of run_length
+  DIST_NEARLY_SORTED, // Sorted, then `swaps` random swaps
+  DIST_ZIPF,          // Skewed: value of rank r drawn with weight 1/r^zipf_s
+  DIST_ALL_EQUAL,
+  DIST_SORTED_RUNS, // Random, each block of run_length sorted
+  DIST_COUNT
+} Distribution;
+
+typedef struct {
+  size_t range;      // Distinct keys before mapping to the type, 0 = default
+  size_t unique;     // Few-unique values, Zipf ranks
+  size_t swaps;      // Nearly-sorted swaps
+  size_t run_length; // Sawtooth and sorted-runs block length
+  double zipf_s;     // Zipf exponent
+} DistParams;
+
+const char *dist_name(Distribution d); // "random", "organ_pipe", ...
+int dist_from_name(const char *name);  // -1 when unknown
+void dist_default_params(DistParams *p);
+// Fills arr (n elements of a built-in type) in parallel, with the same data
+// for the same seed whatever the thread count. TYPE_STRING needs `strings`,
+// where all the strings are allocated at once (ignored for other types).
+// params may be NULL for the defaults.
+// Returns 0, or -1 on a bad type/distribution or out of memory.
+int generate_distribution(void *arr, size_t n, DataType t, Distribution d,
+                          const DistParams *params, unsigned seed,
+                          StringArena *strings);
+
+// --- Number Formatting and Parsing (num_format.c) ---
+// Writes v in decimal, NUL-terminated, to buf (at least 21 bytes); returns
+// the length.
+size_t fmt_int64(char *buf, int64_t v);
+// v with `decimals` (0..9) digits after the point into buf (at least 32
+// bytes), the same text as printf's "%.*f"; returns the length. Products
+// v * 10^decimals of 2^52 and more, other decimals and non-finite values go
+// through snprintf, cut to 31 characters.
+size_t fmt_fixed(char *buf, double v, int decimals);
+// Shortest text that strtod reads back as v exactly ("0.1", "12.75",
+// "0.3333333333333333"), into buf (at least 32 bytes); returns the length.
+size_t fmt_double(char *buf, double v);
+// Parse the number starting at p (after spaces/tabs) and ending at or
+// before end; return the first byte after it, or NULL when there is no
+// number. Integers clamp to the int64_t range like strtoll. Doubles are
+// exact (correctly rounded, as strtod).
+const char *parse_int64(const char *p, const char *end, int64_t *out);
+const char *parse_double(const char *p, const char *end, double *out);
+
+// --- Streaming CSV Reading (csv_stream.c) ---
+// Fields are runs of bytes not in `separators`, empty ones skipped. The file
+// is read in CSV_CHUNK blocks, a field cut by a block boundary carried over
+// to the next one: memory stays at one block plus the longest field.
+#define CSV_CHUNK (1 << 20)
+
+// Gets each field, NUL-terminated in place; nonzero stops the read
+typedef int (*CsvField)(char *field, size_t len, void *user);
+
+// Reads f from its current position to the end. progress (may be NULL) gets
+// the fraction of those bytes consumed, after every block.
+// Returns 0, or -1 on read error, out of memory or when `field` stopped.
+int csv_read_fields(FILE *f, const char *separators, CsvField field,
+                    void *user, SortProgress progress, void *progress_user);
+// Parses the fields of f into a new array of type t, grown geometrically
+// (strings allocated in `strings`); unparsable numbers give 0. *out is
+// malloc'd, NULL when *count is 0. Returns 0, or -1 on error (the strings
+// already read stay in the arena).
+int csv_read_array(FILE *f, const char *separators, DataType t,
+                   StringArena *strings, SortProgress progress, void *user,
+                   void **out, size_t *count);
+
+// --- Binary Array Files (array_file.c) ---
+// Header (magic, version, DataType, count) then the raw little-endian
+// elements; strings as an offsets table and a blob of NUL-terminated text.
+// Opening maps the file privately: the array is used in place and pages
+// written to are copied, the file is left as is.
+typedef struct {
+  void *array;    // count elements of type (char * table for TYPE_STRING)
+  size_t count;
+  DataType type;
+  void *map;      // Whole-file mapping
+  size_t map_len;
+  int owns_array; // array was malloc'd (the string pointer table)
+} ArrayFile;
+
+int array_file_detect(const char *path); // 1 when path has the magic
+// Writes n elements of a built-in type; returns 0, or -1 on error
+int array_file_save(const char *path, const void *arr, size_t n, DataType t);
+// Returns 0, or -1 (af zeroed) on I/O error or malformed file
+int array_file_open(const char *path, ArrayFile *af);
+void array_file_close(ArrayFile *af); // array is invalid afterwards
+
+// --- Sort Traces (sort_trace.c) ---
+// The compare/swap/move events of one sort run, for replaying it without
+// running the algorithm again. An event is packed in 64 bits: the operation
+// in the top 2 bits, then two 31-bit slot indices. Slot TRACE_TEMP stands for
+// the element a kernel holds aside (the insertion key).
+typedef enum {
+  TRACE_CMP,  // Compared slots i and j
+  TRACE_SWAP, // Exchanged slots i and j
+  TRACE_MOVE  // Copied slot j into slot i
+} TraceOp;
+
+typedef uint64_t TraceEvent;
+
+#define TRACE_TEMP 0x7FFFFFFFu
+#define TRACE_MAX_N ((size_t)TRACE_TEMP) // Largest traceable array
+#define TRACE_EVENT(op, i, j)                                                  \
+  ((uint64_t)(op) << 62 | (uint64_t)(i) << 31 | (uint64_t)(j))
+#define TRACE_OP(e) ((TraceOp)((e) >> 62))
+#define TRACE_I(e) ((size_t)((e) >> 31 & TRACE_TEMP))
+#define TRACE_J(e) ((size_t)((e)&TRACE_TEMP))
+
+// Events go to a preallocated ring: once full, the oldest event is folded
+// into `base` and overwritten, so the last `capacity` events stay
+// replayable from the slot contents they started on.
+typedef struct {
+  TraceEvent *events;
+  uint64_t mask;   // capacity - 1, capacity a power of two
+  uint64_t total;  // Events recorded; the ring holds the last capacity
+  size_t n;        // Array length
+  uint32_t *slots; // Input index held by each slot before the oldest event
+  uint32_t temp;   // Same for TRACE_TEMP
+} SortTrace;
+
+// Trace being recorded; the traced kernels write to it (one at a time)
+extern SortTrace *sort_trace_active;
+
+// Applies e to slot contents (input indices, TRACE_TEMP's in *temp)
+static inline void sort_trace_apply(uint32_t *slots, uint32_t *temp,
+                                    TraceEvent e) {
+  size_t i = TRACE_I(e), j = TRACE_J(e);
+  uint32_t *a = i == TRACE_TEMP ? temp : &slots[i];
+  uint32_t *b = j == TRACE_TEMP ? temp : &slots[j];
+  if (TRACE_OP(e) == TRACE_SWAP) {
+    uint32_t x = *a;
+    *a = *b;
+    *b = x;
+  } else if (TRACE_OP(e) == TRACE_MOVE) {
+    *a = *b;
+  }
+}
+
+static inline void sort_trace_emit(TraceOp op, size_t i, size_t j) {
+  SortTrace *t = sort_trace_active;
+  uint64_t k = t->total++;
+  TraceEvent *slot = &t->events[k & t->mask];
+  if (k > t->mask)
+    sort_trace_apply(t->slots, &t->temp, *slot);
+  *slot = TRACE_EVENT(op, i, j);
+}
+
+// capacity is rounded up to a power of two. Returns 0, or -1 when n is over
+// TRACE_MAX_N or out of memory.
+int sort_trace_init(SortTrace *t, size_t n, size_t capacity);
+void sort_trace_free(SortTrace *t);
+uint64_t sort_trace_first(const SortTrace *t); // Oldest event still held
+// Event k, for k in [sort_trace_first(t), t->total)
+TraceEvent sort_trace_event(const SortTrace *t, uint64_t k);
+// Kernel that records into sort_trace_active (sort_typed.c): bubble,
+// insertion, shell and quick. NULL for the other algorithms.
+SortKernel get_sort_kernel_traced(DataType t, SortAlgo algo);
+// Sorts base (n elements of type t) with the traced kernel, recording into
+// trace, which sort_trace_init has sized for n. Returns -1 when the
+// algorithm has no traced kernel.
+int sort_traced(SortTrace *trace, void *base, size_t n, DataType t,
+                SortAlgo algo, SortStats *stats);
+
+// Replays a trace: slots[k] is the input index held by slot k after the
+// first `pos` events. Seeking back restarts from the nearest keyframe, taken
+// every 1/SORT_REPLAY_KEYFRAMES of the trace on the first pass over it.
+#define SORT_REPLAY_KEYFRAMES 16
+
+typedef struct {
+  const SortTrace *trace;
+  uint32_t *slots;
+  uint32_t temp;
+  uint64_t pos;
+  uint64_t key_every;
+  uint32_t *keys[SORT_REPLAY_KEYFRAMES]; // NULL until passed (or OOM)
+  uint32_t key_temp[SORT_REPLAY_KEYFRAMES];
+} SortReplay;
+
+// Positioned on sort_trace_first(trace). Returns 0, or -1 when out of memory
+int sort_replay_init(SortReplay *r, const SortTrace *trace);
+void sort_replay_free(SortReplay *r);
+void sort_replay_seek(SortReplay *r, uint64_t pos); // Clamped to the trace
+
+// --- Hardware Counters (perf_counters.c) ---
+typedef enum {
+  HW_CYCLES,
+  HW_INSTRUCTIONS,
+  HW_L1D_MISSES,
+  HW_LLC_MISSES,
+  HW_BRANCH_MISSES,
+  HW_COUNT
+} HwCounter;
+
+typedef struct {
+  int fd[HW_COUNT]; // -1 when the event is not available
+} HwCounters;
+
+const char *hw_counter_name(HwCounter c); // "cycles", "l1d_misses", ...
+// Opens the counters for the calling thread and the threads it spawns.
+// Returns 0 when at least one event is available, -1 otherwise (not Linux,
+// no PMU, perf_event_paranoid too strict).
+int hw_counters_open(HwCounters *hc);
+void hw_counters_start(HwCounters *hc); // Reset and enable
+// Disables and reads; bit e of the result is set when out[e] is valid
+unsigned hw_counters_stop(HwCounters *hc, double out[HW_COUNT]);
+void hw_counters_close(HwCounters *hc);
+
+// --- Benchmarking (benchmark.c) ---
+typedef struct {
+  int warmup;       // Runs whose time is not recorded
+  int min_reps;     // Timed runs: at least min_reps, then more until
+  int max_reps;     // budget_ms of total run time or max_reps is reached.
+  double budget_ms; // A single run over budget_ms is measured only once.
+  const atomic_int *cancel; // Optional: set by another thread, checked
+                            // before every run
+  int hw_counters;          // Also read hardware counters if available
+} BenchOptions;
+
+typedef struct {
+  int reps; // Number of samples
+  double min, median, p95, mean, stddev; // Milliseconds
+  unsigned hw_mask;   // Bit e set when hw[e] was measured
+  double hw[HW_COUNT]; // Hardware counters, mean per timed run
+} BenchResult;
+
+// setup (untimed, may be NULL) prepares the input, run is the timed body
+typedef void (*BenchFunc)(void *ctx);
+
+double bench_now_ms(void); // Monotonic wall clock
+void bench_default_options(BenchOptions *opt);
+// Returns 0, or -1 when out of memory or cancelled
+int bench_measure(const BenchOptions *opt, BenchFunc setup, BenchFunc run,
+                  void *ctx, BenchResult *out);
+
+// In-memory size of one element (char * for TYPE_STRING), 0 for TYPE_CUSTOM
+size_t get_element_size(DataType t);
+
+// Specialized kernel for a built-in DataType (see sort_template.h).
+// NULL for TYPE_CUSTOM or when the algorithm does not apply to the type.
+SortKernel get_sort_kernel(DataType t, SortAlgo algo);
+// Same kernel built without operation counting, for timing runs: counts
+// come from a separate get_sort_kernel run.
+SortKernel get_sort_kernel_clean(DataType t, SortAlgo algo);
+
+// Selection queries, cheaper than a full sort when only part of the order
+// is needed. The array is permuted in place.
+typedef enum {
+  SELECT_NTH,     // arr[k] is the element of rank k (0-based), smaller or
+                  // equal ones before it, greater or equal ones after: O(n)
+  SELECT_PARTIAL, // The k smallest, sorted, in arr[0..k): O(n + k log k)
+  SELECT_TOP_K,   // The k largest, largest first, in arr[0..k): O(n log k)
+  SELECT_COUNT
+} SelectOp;
+
+// k past the end: SELECT_NTH does nothing, the others take the whole array
+typedef void (*SelectKernel)(void *base, size_t n, size_t k, SortStats *stats);
+
+// NULL for TYPE_CUSTOM (use the *_gen functions)
+SelectKernel get_select_kernel(DataType t, SelectOp op);
+SelectKernel get_select_kernel_clean(DataType t, SelectOp op);
+
+// Instantiations of sort_template.h (sort_typed.c)
+void sort_bubble_int(void *base, size_t n, SortStats *stats);
+void sort_insertion_int(void *base, size_t n, SortStats *stats);
+void sort_shell_int(void *base, size_t n, SortStats *stats);
+void sort_quick_int(void *base, size_t n, SortStats *stats);
+void sort_par_quick_int(void *base, size_t n, SortStats *stats);
+void sort_par_merge_int(void *base, size_t n, SortStats *stats);
+void sort_natural_int(void *base, size_t n, SortStats *stats);
+void sort_bubble_double(void *base, size_t n, SortStats *stats);
+void sort_insertion_double(void *base, size_t n, SortStats *stats);
+void sort_shell_double(void *base, size_t n, SortStats *stats);
+void sort_quick_double(void *base, size_t n, SortStats *stats);
+void sort_par_quick_double(void *base, size_t n, SortStats *stats);
+void sort_par_merge_double(void *base, size_t n, SortStats *stats);
+void sort_natural_double(void *base, size_t n, SortStats *stats);
+void sort_bubble_char(void *base, size_t n, SortStats *stats);
+void sort_insertion_char(void *base, size_t n, SortStats *stats);
+void sort_shell_char(void *base, size_t n, SortStats *stats);
+void sort_quick_char(void *base, size_t n, SortStats *stats);
+void sort_par_quick_char(void *base, size_t n, SortStats *stats);
+void sort_par_merge_char(void *base, size_t n, SortStats *stats);
+void sort_natural_char(void *base, size_t n, SortStats *stats);
+void sort_bubble_str(void *base, size_t n, SortStats *stats);
+void sort_insertion_str(void *base, size_t n, SortStats *stats);
+void sort_shell_str(void *base, size_t n, SortStats *stats);
+void sort_quick_str(void *base, size_t n, SortStats *stats);
+void sort_par_quick_str(void *base, size_t n, SortStats *stats);
+void sort_par_merge_str(void *base, size_t n, SortStats *stats);
+void sort_natural_str(void *base, size_t n, SortStats *stats);
+void sort_quick_int_clean(void *base, size_t n, SortStats *stats);
+void sort_quick_double_clean(void *base, size_t n, SortStats *stats);
+void sort_quick_str_clean(void *base, size_t n, SortStats *stats);
+void select_nth_int(void *base, size_t n, size_t k, SortStats *stats);
+void partial_sort_int(void *base, size_t n, size_t k, SortStats *stats);
+void top_k_int(void *base, size_t n, size_t k, SortStats *stats);
+void select_nth_double(void *base, size_t n, size_t k, SortStats *stats);
+void partial_sort_double(void *base, size_t n, size_t k, SortStats *stats);
+void top_k_double(void *base, size_t n, size_t k, SortStats *stats);
+void select_nth_char(void *base, size_t n, size_t k, SortStats *stats);
+void partial_sort_char(void *base, size_t n, size_t k, SortStats *stats);
+void top_k_char(void *base, size_t n, size_t k, SortStats *stats);
+void select_nth_str(void *base, size_t n, size_t k, SortStats *stats);
+void partial_sort_str(void *base, size_t n, size_t k, SortStats *stats);
+void top_k_str(void *base, size_t n, size_t k, SortStats *stats);
+
 typedef struct Node {
   void *data;
   struct Node *next;
@@ -56,6 +515,13 @@ typedef struct {
 } LinkedList;
 
 void list_init(LinkedList *list, DataType type, int is_doubly);
+// Links nodes[0..n) in order over the n elements of `values` (a char *
+// array for TYPE_STRING), without any allocation. list_sort only moves node
+// links and data pointers, so the same storage can be relinked for every
+// benchmark run. Such a list must not be passed to list_clear or the
+// insert/remove functions.
+void list_init_pooled(LinkedList *list, DataType type, int is_doubly,
+                      Node *nodes, const void *values, size_t n);
 void list_append(LinkedList *list, void *value);
 void list_prepend(LinkedList *list, void *value);
 void list_insert_at(LinkedList *list, int index, void *value);
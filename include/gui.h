@@ -1,6 +1,7 @@
 #ifndef GUI_H
 #define GUI_H
 
+#include "backend.h"
 #include <gtk/gtk.h>
 
 // Main Window
@@ -13,4 +14,37 @@ GtkWidget *create_tab_list(void);
 GtkWidget *create_tab_tree(void);
 GtkWidget *create_tab_graph(void);
 
+// Y axis of the benchmark charts (sort and list tabs)
+typedef enum {
+  METRIC_TIME, // Median, with min..p95 error bars
+  METRIC_CYCLES,
+  METRIC_INSTRUCTIONS,
+  METRIC_IPC,
+  METRIC_L1D_MISSES,
+  METRIC_LLC_MISSES,
+  METRIC_BRANCH_MISSES,
+  METRIC_COUNT
+} ChartMetric;
+
+GtkWidget *chart_metric_combo(void); // Combo box listing the metrics
+const char *chart_metric_label(ChartMetric m);
+// Value of one benchmark point; returns 0, or -1 when it was not measured
+// (hardware counters unavailable)
+int chart_metric_value(const BenchResult *r, ChartMetric m, double *out);
+void chart_format_value(char *buf, size_t size, double v, ChartMetric m);
+
+// Virtual list of an array's elements (data_view.c). Only the visible rows
+// are formatted, when drawn, so any size scrolls the same. Has a "go to"
+// entry taking an index or a range a-b, which is then highlighted.
+typedef struct DataView DataView;
+
+DataView *data_view_new(void); // Freed with its widget
+GtkWidget *data_view_widget(DataView *v);
+// arr is borrowed until the next call; NULL or n == 0 shows nothing.
+// Clears the message and the highlight.
+void data_view_set_data(DataView *v, const void *arr, size_t n, DataType t);
+void data_view_set_message(DataView *v, const char *msg); // NULL hides it
+void data_view_scroll_to(DataView *v, size_t index);
+void data_view_highlight(DataView *v, size_t lo, size_t hi); // Rows [lo, hi)
+
 #endif
@@ -0,0 +1,332 @@
+// Generic sort and selection template over void* elements of any size,
+// ordered by a CompareFunc. Included by sort_generic.c, once per build:
+//   GEN_SUFFIX      name suffix (sort_bubble_<suffix>, ...)
+//   GEN_NO_STATS    (optional) compile the SortStats counting out
+// The includer provides swap_gen(a, b, size).
+
+#define GT_CAT_(a, b) a##_##b
+#define GT_CAT(a, b) GT_CAT_(a, b)
+#define GT_FN(name) GT_CAT(name, GEN_SUFFIX)
+
+#ifdef GEN_NO_STATS
+#define GT_CMP(stats, k) ((void)(stats))
+#define GT_ASG(stats, k) ((void)(stats))
+#else
+#define GT_CMP(stats, k) ((stats)->comparisons += (k))
+#define GT_ASG(stats, k) ((stats)->assignments += (k))
+#endif
+
+#define GT_CUTOFF 16
+#define AT(i) (arr + (i) * size)
+
+// 1. Bubble Sort
+void GT_FN(sort_bubble)(void *base, size_t n, size_t size, CompareFunc cmp,
+                        SortStats *stats) {
+  if (n < 2)
+    return;
+  char *arr = (char *)base;
+  for (size_t i = 0; i < n - 1; i++) {
+    for (size_t j = 0; j < n - i - 1; j++) {
+      GT_CMP(stats, 1);
+      if (cmp(arr + j * size, arr + (j + 1) * size) > 0) {
+        swap_gen(arr + j * size, arr + (j + 1) * size, size);
+        GT_ASG(stats, 3);
+      }
+    }
+  }
+}
+
+// 2. Insertion Sort
+void GT_FN(sort_insertion)(void *base, size_t n, size_t size, CompareFunc cmp,
+                           SortStats *stats) {
+  char *arr = (char *)base;
+  char key[size];
+  for (size_t i = 1; i < n; i++) {
+    memcpy(key, arr + i * size, size);
+    long j = i - 1;
+    while (j >= 0) {
+      GT_CMP(stats, 1);
+      if (cmp(arr + j * size, key) > 0) {
+        memcpy(arr + (j + 1) * size, arr + j * size, size);
+        GT_ASG(stats, 1);
+        j--;
+      } else {
+        break;
+      }
+    }
+    memcpy(arr + (j + 1) * size, key, size);
+    GT_ASG(stats, 1);
+  }
+}
+
+// 3. Shell Sort
+void GT_FN(sort_shell)(void *base, size_t n, size_t size, CompareFunc cmp,
+                       SortStats *stats) {
+  char *arr = (char *)base;
+  for (size_t gap = n / 2; gap > 0; gap /= 2) {
+    for (size_t i = gap; i < n; i++) {
+      char temp[size];
+      memcpy(temp, arr + i * size, size);
+      size_t j;
+      for (j = i; j >= gap; j -= gap) {
+        GT_CMP(stats, 1);
+        if (cmp(arr + (j - gap) * size, temp) > 0) {
+          memcpy(arr + j * size, arr + (j - gap) * size, size);
+          GT_ASG(stats, 1);
+        } else
+          break;
+      }
+      memcpy(arr + j * size, temp, size);
+    }
+  }
+}
+
+// 4. Quick Sort (Introsort: ninther pivot, insertion cutoff, heap fallback)
+static void GT_FN(insertion_range)(char *arr, size_t lo, size_t hi, size_t size,
+                                   CompareFunc cmp, SortStats *stats) {
+  char key[size];
+  for (size_t i = lo + 1; i < hi; i++) {
+    memcpy(key, AT(i), size);
+    size_t j = i;
+    while (j > lo) {
+      GT_CMP(stats, 1);
+      if (cmp(AT(j - 1), key) > 0) {
+        memcpy(AT(j), AT(j - 1), size);
+        GT_ASG(stats, 1);
+        j--;
+      } else
+        break;
+    }
+    memcpy(AT(j), key, size);
+    GT_ASG(stats, 1);
+  }
+}
+
+static void GT_FN(sift_down)(char *arr, size_t root, size_t n, size_t size,
+                             CompareFunc cmp, SortStats *stats) {
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= n)
+      return;
+    if (child + 1 < n) {
+      GT_CMP(stats, 1);
+      if (cmp(AT(child), AT(child + 1)) < 0)
+        child++;
+    }
+    GT_CMP(stats, 1);
+    if (cmp(AT(root), AT(child)) >= 0)
+      return;
+    swap_gen(AT(root), AT(child), size);
+    GT_ASG(stats, 3);
+    root = child;
+  }
+}
+
+static void GT_FN(heap_range)(char *arr, size_t n, size_t size, CompareFunc cmp,
+                              SortStats *stats) {
+  for (size_t i = n / 2; i > 0; i--)
+    GT_FN(sift_down)(arr, i - 1, n, size, cmp, stats);
+  for (size_t end = n - 1; end > 0; end--) {
+    swap_gen(AT(0), AT(end), size);
+    GT_ASG(stats, 3);
+    GT_FN(sift_down)(arr, 0, end, size, cmp, stats);
+  }
+}
+
+static size_t GT_FN(median3)(char *arr, size_t a, size_t b, size_t c,
+                             size_t size, CompareFunc cmp, SortStats *stats) {
+  GT_CMP(stats, 2);
+  if (cmp(AT(a), AT(b)) < 0) {
+    if (cmp(AT(b), AT(c)) < 0)
+      return b;
+    GT_CMP(stats, 1);
+    return cmp(AT(a), AT(c)) < 0 ? c : a;
+  }
+  if (cmp(AT(a), AT(c)) < 0)
+    return a;
+  GT_CMP(stats, 1);
+  return cmp(AT(b), AT(c)) < 0 ? c : b;
+}
+
+static size_t GT_FN(partition)(char *arr, size_t lo, size_t hi, size_t size,
+                               CompareFunc cmp, SortStats *stats) {
+  size_t n = hi - lo, mid = lo + n / 2, p;
+  if (n < 128) {
+    p = GT_FN(median3)(arr, lo, mid, hi - 1, size, cmp, stats);
+  } else {
+    size_t s = n / 8;
+    size_t a = GT_FN(median3)(arr, lo, lo + s, lo + 2 * s, size, cmp, stats);
+    size_t b = GT_FN(median3)(arr, mid - s, mid, mid + s, size, cmp, stats);
+    size_t c = GT_FN(median3)(arr, hi - 1 - 2 * s, hi - 1 - s, hi - 1, size,
+                              cmp, stats);
+    p = GT_FN(median3)(arr, a, b, c, size, cmp, stats);
+  }
+  swap_gen(AT(lo), AT(p), size);
+  GT_ASG(stats, 3);
+
+  // Hoare scan: both sides stop on equal keys so duplicates split evenly
+  size_t i = lo, j = hi;
+  for (;;) {
+    do {
+      i++;
+      GT_CMP(stats, 1);
+    } while (i < hi - 1 && cmp(AT(i), AT(lo)) < 0);
+    do {
+      j--;
+      GT_CMP(stats, 1);
+    } while (cmp(AT(j), AT(lo)) > 0);
+    if (i >= j)
+      break;
+    swap_gen(AT(i), AT(j), size);
+    GT_ASG(stats, 3);
+  }
+  swap_gen(AT(lo), AT(j), size);
+  GT_ASG(stats, 3);
+  return j;
+}
+
+static void GT_FN(introsort)(char *arr, size_t lo, size_t hi, int depth,
+                             size_t size, CompareFunc cmp, SortStats *stats) {
+  while (hi - lo > GT_CUTOFF) {
+    if (depth == 0) {
+      GT_FN(heap_range)(AT(lo), hi - lo, size, cmp, stats);
+      return;
+    }
+    depth--;
+    size_t p = GT_FN(partition)(arr, lo, hi, size, cmp, stats);
+    // Smaller side recursive, larger side iterative: O(log n) stack
+    if (p - lo < hi - p - 1) {
+      GT_FN(introsort)(arr, lo, p, depth, size, cmp, stats);
+      lo = p + 1;
+    } else {
+      GT_FN(introsort)(arr, p + 1, hi, depth, size, cmp, stats);
+      hi = p;
+    }
+  }
+  GT_FN(insertion_range)(arr, lo, hi, size, cmp, stats);
+}
+
+void GT_FN(sort_quick)(void *base, size_t n, size_t size, CompareFunc cmp,
+                       SortStats *stats) {
+  if (n < 2)
+    return;
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  GT_FN(introsort)((char *)base, 0, n, depth, size, cmp, stats);
+}
+
+// --- Selection (same algorithms as the typed select_nth, partial_sort and
+// top_k in sort_template.h) ---
+
+// Introselect fallback: max-heap over [lo, k], root moved to slot k
+static void GT_FN(heap_select)(char *arr, size_t lo, size_t hi, size_t k,
+                               size_t size, CompareFunc cmp,
+                               SortStats *stats) {
+  size_t m = k - lo + 1;
+  for (size_t i = m / 2; i > 0; i--)
+    GT_FN(sift_down)(AT(lo), i - 1, m, size, cmp, stats);
+  for (size_t i = k + 1; i < hi; i++) {
+    GT_CMP(stats, 1);
+    if (cmp(AT(i), AT(lo)) < 0) {
+      swap_gen(AT(lo), AT(i), size);
+      GT_ASG(stats, 3);
+      GT_FN(sift_down)(AT(lo), 0, m, size, cmp, stats);
+    }
+  }
+  swap_gen(AT(lo), AT(k), size);
+  GT_ASG(stats, 3);
+}
+
+void GT_FN(select_nth)(void *base, size_t n, size_t size, size_t k,
+                       CompareFunc cmp, SortStats *stats) {
+  char *arr = (char *)base;
+  if (k >= n)
+    return;
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  size_t lo = 0, hi = n;
+  while (hi - lo > GT_CUTOFF) {
+    if (depth == 0) {
+      GT_FN(heap_select)(arr, lo, hi, k, size, cmp, stats);
+      return;
+    }
+    depth--;
+    size_t p = GT_FN(partition)(arr, lo, hi, size, cmp, stats);
+    if (k == p)
+      return;
+    if (k < p)
+      hi = p;
+    else
+      lo = p + 1;
+  }
+  GT_FN(insertion_range)(arr, lo, hi, size, cmp, stats);
+}
+
+void GT_FN(partial_sort)(void *base, size_t n, size_t size, size_t k,
+                         CompareFunc cmp, SortStats *stats) {
+  if (k >= n) {
+    GT_FN(sort_quick)(base, n, size, cmp, stats);
+    return;
+  }
+  if (k == 0)
+    return;
+  GT_FN(select_nth)(base, n, size, k - 1, cmp, stats);
+  GT_FN(sort_quick)(base, k - 1, size, cmp, stats);
+}
+
+static void GT_FN(min_sift_down)(char *arr, size_t root, size_t n,
+                                 size_t size, CompareFunc cmp,
+                                 SortStats *stats) {
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= n)
+      return;
+    if (child + 1 < n) {
+      GT_CMP(stats, 1);
+      if (cmp(AT(child + 1), AT(child)) < 0)
+        child++;
+    }
+    GT_CMP(stats, 1);
+    if (cmp(AT(child), AT(root)) >= 0)
+      return;
+    swap_gen(AT(root), AT(child), size);
+    GT_ASG(stats, 3);
+    root = child;
+  }
+}
+
+void GT_FN(top_k)(void *base, size_t n, size_t size, size_t k, CompareFunc cmp,
+                  SortStats *stats) {
+  char *arr = (char *)base;
+  if (k > n)
+    k = n;
+  if (k == 0)
+    return;
+  for (size_t i = k / 2; i > 0; i--)
+    GT_FN(min_sift_down)(arr, i - 1, k, size, cmp, stats);
+  for (size_t i = k; i < n; i++) {
+    GT_CMP(stats, 1);
+    if (cmp(AT(0), AT(i)) < 0) {
+      swap_gen(AT(0), AT(i), size);
+      GT_ASG(stats, 3);
+      GT_FN(min_sift_down)(arr, 0, k, size, cmp, stats);
+    }
+  }
+  for (size_t end = k - 1; end > 0; end--) {
+    swap_gen(AT(0), AT(end), size);
+    GT_ASG(stats, 3);
+    GT_FN(min_sift_down)(arr, 0, end, size, cmp, stats);
+  }
+}
+
+#undef AT
+#undef GT_CUTOFF
+#undef GT_CMP
+#undef GT_ASG
+#undef GT_FN
+#undef GT_CAT
+#undef GT_CAT_
+#undef GEN_SUFFIX
+#undef GEN_NO_STATS
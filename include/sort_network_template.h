@@ -0,0 +1,87 @@
+// Sorting network entry points, included twice by sort_network.c after its
+// AVX2 kernels. No include guard: the includer defines
+//   SORT_NO_STATS     (optional) compile the SortStats counting out; the
+//                     stats argument is then ignored (timing builds)
+// and gets sort_network_{int,double}, with a _clean suffix in the build
+// without counting, which the _clean introsorts of sort_typed.c use as
+// their base case.
+
+#ifdef SORT_NO_STATS
+#define NS_FN(name) name##_clean
+#define NS_CMP(stats, k) ((void)(stats))
+#define NS_ASG(stats, k) ((void)(stats))
+#else
+#define NS_FN(name) name
+#define NS_CMP(stats, k) ((stats)->comparisons += (k))
+#define NS_ASG(stats, k) ((stats)->assignments += (k))
+#endif
+
+// Scalar fallback: plain insertion sort, same accounting as the kernels
+static void NS_FN(insertion_int)(int *arr, size_t n, SortStats *stats) {
+  for (size_t i = 1; i < n; i++) {
+    int key = arr[i];
+    size_t j = i;
+    while (j > 0) {
+      NS_CMP(stats, 1);
+      if (arr[j - 1] > key) {
+        arr[j] = arr[j - 1];
+        NS_ASG(stats, 1);
+        j--;
+      } else
+        break;
+    }
+    arr[j] = key;
+    NS_ASG(stats, 1);
+  }
+}
+
+static void NS_FN(insertion_double)(double *arr, size_t n, SortStats *stats) {
+  for (size_t i = 1; i < n; i++) {
+    double key = arr[i];
+    size_t j = i;
+    while (j > 0) {
+      NS_CMP(stats, 1);
+      if (arr[j - 1] > key) {
+        arr[j] = arr[j - 1];
+        NS_ASG(stats, 1);
+        j--;
+      } else
+        break;
+    }
+    arr[j] = key;
+    NS_ASG(stats, 1);
+  }
+}
+
+void NS_FN(sort_network_int)(int *arr, size_t n, SortStats *stats) {
+  if (n < 2)
+    return;
+#ifdef HAVE_AVX2_NETWORK
+  if (n <= SORT_NETWORK_MAX && sort_network_available()) {
+    network_avx2_int(arr, n);
+    NS_CMP(stats, network_comparisons(n, 8, 3));
+    NS_ASG(stats, 2 * n);
+    return;
+  }
+#endif
+  NS_FN(insertion_int)(arr, n, stats);
+}
+
+void NS_FN(sort_network_double)(double *arr, size_t n, SortStats *stats) {
+  if (n < 2)
+    return;
+#ifdef HAVE_AVX2_NETWORK
+  if (n <= SORT_NETWORK_MAX && sort_network_available() &&
+      network_avx2_double(arr, n)) {
+    NS_CMP(stats, network_comparisons(n, 4, 2));
+    NS_ASG(stats, 2 * n);
+    return;
+  }
+#endif
+  NS_FN(insertion_double)(arr, n, stats);
+}
+
+#undef NS_FN
+#undef NS_CMP
+#undef NS_ASG
+#undef SORT_NO_STATS
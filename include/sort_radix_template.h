@@ -0,0 +1,188 @@
+// Radix and counting sort template, included twice by sort.c.
+// No include guard: the includer defines
+//   SORT_NO_STATS     (optional) compile the SortStats counting out; the
+//                     stats argument is then ignored (timing builds)
+// and gets sort_radix_{int,double} and sort_counting_{int,char}, with a
+// _clean suffix in the build without counting. That build falls back on
+// sort_quick_{int,double}_clean, so nothing it reaches writes to stats.
+
+#ifdef SORT_NO_STATS
+#define RS_FN(name) name##_clean
+#define RS_RESET(stats) ((void)(stats))
+#define RS_CMP(stats, k) ((void)(stats))
+#define RS_ASG(stats, k) ((void)(stats))
+#else
+#define RS_FN(name) name
+#define RS_RESET(stats) ((stats)->comparisons = 0, (stats)->assignments = 0)
+#define RS_CMP(stats, k) ((stats)->comparisons += (k))
+#define RS_ASG(stats, k) ((stats)->assignments += (k))
+#endif
+
+// --- Radix Sort (LSD, 8 bits per pass) ---
+// Keys are mapped to unsigned integers whose natural order matches the
+// signed/IEEE order, then scattered byte by byte between the array and a
+// scratch buffer. Passes where every key shares the same byte are skipped.
+// There are no comparisons; assignments count element moves. Without
+// memory for the scratch buffer the keys are left as they are and the
+// array is sorted by the typed introsort instead.
+
+// Returns -1, keys untouched, when out of memory
+static int RS_FN(radix_u32)(uint32_t *keys, size_t n, SortStats *stats) {
+  uint32_t *tmp = malloc(n * sizeof(uint32_t));
+  if (!tmp)
+    return -1;
+  size_t count[4][256] = {{0}};
+  for (size_t i = 0; i < n; i++)
+    for (int b = 0; b < 4; b++)
+      count[b][(keys[i] >> (8 * b)) & 0xFF]++;
+
+  uint32_t *src = keys, *dst = tmp;
+  for (int b = 0; b < 4; b++) {
+    if (count[b][(src[0] >> (8 * b)) & 0xFF] == n)
+      continue;
+    size_t pos[256], sum = 0;
+    for (int d = 0; d < 256; d++) {
+      pos[d] = sum;
+      sum += count[b][d];
+    }
+    for (size_t i = 0; i < n; i++)
+      dst[pos[(src[i] >> (8 * b)) & 0xFF]++] = src[i];
+    RS_ASG(stats, n);
+    uint32_t *t = src;
+    src = dst;
+    dst = t;
+  }
+  if (src != keys) {
+    memcpy(keys, src, n * sizeof(uint32_t));
+    RS_ASG(stats, n);
+  }
+  free(tmp);
+  return 0;
+}
+
+static int RS_FN(radix_u64)(uint64_t *keys, size_t n, SortStats *stats) {
+  size_t(*count)[256] = calloc(8, sizeof(*count));
+  uint64_t *tmp = malloc(n * sizeof(uint64_t));
+  if (!count || !tmp) {
+    free(count);
+    free(tmp);
+    return -1;
+  }
+  for (size_t i = 0; i < n; i++)
+    for (int b = 0; b < 8; b++)
+      count[b][(keys[i] >> (8 * b)) & 0xFF]++;
+
+  uint64_t *src = keys, *dst = tmp;
+  for (int b = 0; b < 8; b++) {
+    if (count[b][(src[0] >> (8 * b)) & 0xFF] == n)
+      continue;
+    size_t pos[256], sum = 0;
+    for (int d = 0; d < 256; d++) {
+      pos[d] = sum;
+      sum += count[b][d];
+    }
+    for (size_t i = 0; i < n; i++)
+      dst[pos[(src[i] >> (8 * b)) & 0xFF]++] = src[i];
+    RS_ASG(stats, n);
+    uint64_t *t = src;
+    src = dst;
+    dst = t;
+  }
+  if (src != keys) {
+    memcpy(keys, src, n * sizeof(uint64_t));
+    RS_ASG(stats, n);
+  }
+  free(tmp);
+  free(count);
+  return 0;
+}
+
+void RS_FN(sort_radix_int)(int *arr, size_t n, SortStats *stats) {
+  RS_RESET(stats);
+  if (n < 2)
+    return;
+  // Flipping the sign bit turns two's complement order into unsigned order
+  uint32_t *keys = (uint32_t *)arr;
+  for (size_t i = 0; i < n; i++)
+    keys[i] ^= 0x80000000u;
+  int sorted = RS_FN(radix_u32)(keys, n, stats) == 0;
+  for (size_t i = 0; i < n; i++)
+    keys[i] ^= 0x80000000u;
+  if (!sorted)
+    RS_FN(sort_quick_int)(arr, n, stats);
+}
+
+void RS_FN(sort_radix_double)(double *arr, size_t n, SortStats *stats) {
+  RS_RESET(stats);
+  if (n < 2)
+    return;
+  // Mapped in place, as sort_radix_int does, and only read as uint64_t
+  // here. Negative values: invert all bits. Positive values: set the sign
+  // bit.
+  uint64_t *keys = (uint64_t *)(void *)arr;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t u = keys[i];
+    keys[i] = (u & 0x8000000000000000ull) ? ~u : u | 0x8000000000000000ull;
+  }
+  int sorted = RS_FN(radix_u64)(keys, n, stats) == 0;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t u = keys[i];
+    keys[i] = (u & 0x8000000000000000ull) ? u & ~0x8000000000000000ull : ~u;
+  }
+  if (!sorted)
+    RS_FN(sort_quick_double)(arr, n, stats);
+}
+
+// --- Counting Sort ---
+// Used when a min/max pre-scan shows the key range is small compared to n.
+// Comparisons count the pre-scan, assignments the elements written back.
+
+int RS_FN(sort_counting_int)(int *arr, size_t n, SortStats *stats) {
+  RS_RESET(stats);
+  if (n < 2)
+    return 1;
+
+  int min = arr[0], max = arr[0];
+  for (size_t i = 1; i < n; i++) {
+    RS_CMP(stats, 2);
+    if (arr[i] < min)
+      min = arr[i];
+    else if (arr[i] > max)
+      max = arr[i];
+  }
+  size_t range = (size_t)((long long)max - min) + 1;
+  if (range > COUNTING_MAX_RANGE || range > 4 * n + 256)
+    return 0;
+
+  size_t *count = calloc(range, sizeof(size_t));
+  if (!count)
+    return 0;
+  for (size_t i = 0; i < n; i++)
+    count[arr[i] - min]++;
+  size_t k = 0;
+  for (size_t v = 0; v < range; v++)
+    for (size_t c = count[v]; c > 0; c--)
+      arr[k++] = (int)(min + (long long)v);
+  RS_ASG(stats, n);
+  free(count);
+  return 1;
+}
+
+void RS_FN(sort_counting_char)(char *arr, size_t n, SortStats *stats) {
+  RS_RESET(stats);
+  size_t count[UCHAR_MAX + 1] = {0};
+  // Offsetting by CHAR_MIN keeps the order of plain char on either signedness
+  for (size_t i = 0; i < n; i++)
+    count[arr[i] - CHAR_MIN]++;
+  size_t k = 0;
+  for (int v = 0; v <= UCHAR_MAX; v++)
+    for (size_t c = count[v]; c > 0; c--)
+      arr[k++] = (char)(v + CHAR_MIN);
+  RS_ASG(stats, n);
+}
+
+#undef RS_FN
+#undef RS_RESET
+#undef RS_CMP
+#undef RS_ASG
+#undef SORT_NO_STATS
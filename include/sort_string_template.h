@@ -0,0 +1,307 @@
+// String sort template, instantiated twice by sort_string.c.
+// No include guard: the includer defines, for each instantiation,
+//   SS_SUFFIX         name suffix (str, str_clean)
+//   SORT_NO_STATS     (optional) compile the SortStats counting out; the
+//                     stats argument is then ignored (timing builds)
+// and gets sort_multikey_<suffix> and sort_prefix_<suffix>. The strings are
+// read through char *, which may alias the counters, so the counting build
+// stores every increment; only a build without them times the bare kernel.
+
+#define SS_CAT_(a, b) a##_##b
+#define SS_CAT(a, b) SS_CAT_(a, b)
+#define SS_FN(name) SS_CAT(name, SS_SUFFIX)
+
+#ifdef SORT_NO_STATS
+#define SS_CMP(stats, k) ((void)(stats))
+#define SS_ASG(stats, k) ((void)(stats))
+#define SS_AVD(stats, k) ((void)(stats))
+#else
+#define SS_CMP(stats, k) ((stats)->comparisons += (k))
+#define SS_ASG(stats, k) ((stats)->assignments += (k))
+#define SS_AVD(stats, k) ((stats)->avoided += (k))
+#endif
+
+// Compares from byte d on; both strings share their first d bytes
+static int SS_FN(less_from)(const char *a, const char *b, size_t d,
+                            SortStats *stats) {
+  const unsigned char *x = (const unsigned char *)a + d;
+  const unsigned char *y = (const unsigned char *)b + d;
+  for (;;) {
+    SS_CMP(stats, 1);
+    if (*x != *y)
+      return *x < *y;
+    if (*x == 0)
+      return 0;
+    x++;
+    y++;
+  }
+}
+
+static void SS_FN(insertion)(char **arr, size_t n, size_t depth,
+                             SortStats *stats) {
+  for (size_t i = 1; i < n; i++) {
+    char *key = arr[i];
+    size_t j = i;
+    while (j > 0 && SS_FN(less_from)(key, arr[j - 1], depth, stats)) {
+      arr[j] = arr[j - 1];
+      SS_ASG(stats, 1);
+      j--;
+    }
+    arr[j] = key;
+    SS_ASG(stats, 1);
+  }
+}
+
+static size_t SS_FN(med3_byte)(char **arr, size_t a, size_t b, size_t c,
+                               size_t d, SortStats *stats) {
+  int va = CH(arr[a], d), vb = CH(arr[b], d), vc = CH(arr[c], d);
+  SS_CMP(stats, 3);
+  if (va < vb)
+    return vb < vc ? b : (va < vc ? c : a);
+  return va < vc ? a : (vb < vc ? c : b);
+}
+
+static void SS_FN(sort_rec)(char **arr, size_t n, size_t depth, char **aux,
+                            SortStats *stats);
+
+// One MSD pass on byte `depth`, through aux (at least n slots)
+static void SS_FN(msd_pass)(char **arr, size_t n, size_t depth, char **aux,
+                            SortStats *stats) {
+  size_t count[257] = {0};
+  for (size_t i = 0; i < n; i++)
+    count[CH(arr[i], depth) + 1]++;
+  SS_CMP(stats, n);
+  for (int b = 0; b < 256; b++)
+    count[b + 1] += count[b];
+
+  size_t pos[256];
+  memcpy(pos, count, sizeof(pos));
+  for (size_t i = 0; i < n; i++)
+    aux[pos[CH(arr[i], depth)]++] = arr[i];
+  memcpy(arr, aux, n * sizeof(char *));
+  SS_ASG(stats, 2 * n);
+
+  // Bucket 0 holds strings that ended here: all equal, nothing to do
+  for (int b = 1; b < 256; b++) {
+    size_t lo = count[b], hi = count[b + 1];
+    if (hi - lo > 1)
+      SS_FN(sort_rec)(arr + lo, hi - lo, depth + 1, aux, stats);
+  }
+}
+
+static void SS_FN(sort_rec)(char **arr, size_t n, size_t depth, char **aux,
+                            SortStats *stats) {
+  while (n > MKQS_CUTOFF) {
+    if (n >= MSD_THRESHOLD) {
+      SS_FN(msd_pass)(arr, n, depth, aux, stats);
+      return;
+    }
+
+    size_t m = SS_FN(med3_byte)(arr, 0, n / 2, n - 1, depth, stats);
+    swap_str(&arr[0], &arr[m]);
+    SS_ASG(stats, 3);
+    int v = CH(arr[0], depth);
+
+    // Bentley-McIlroy split: equal keys parked at both ends, then swapped
+    // to the middle. [0,a) and (d,n) equal, [a,b) less, (c,d] greater.
+    size_t a = 1, b = 1, c = n - 1, d = n - 1;
+    for (;;) {
+      int r;
+      while (b <= c) {
+        SS_CMP(stats, 1);
+        r = CH(arr[b], depth) - v;
+        if (r > 0)
+          break;
+        if (r == 0) {
+          swap_str(&arr[a++], &arr[b]);
+          SS_ASG(stats, 3);
+        }
+        b++;
+      }
+      while (b <= c) {
+        SS_CMP(stats, 1);
+        r = CH(arr[c], depth) - v;
+        if (r < 0)
+          break;
+        if (r == 0) {
+          swap_str(&arr[c], &arr[d--]);
+          SS_ASG(stats, 3);
+        }
+        c--;
+      }
+      if (b > c)
+        break;
+      swap_str(&arr[b++], &arr[c--]);
+      SS_ASG(stats, 3);
+    }
+
+    size_t k = a < b - a ? a : b - a;
+    for (size_t i = 0; i < k; i++)
+      swap_str(&arr[i], &arr[b - k + i]);
+    size_t l = d - c < n - 1 - d ? d - c : n - 1 - d;
+    for (size_t i = 0; i < l; i++)
+      swap_str(&arr[b + i], &arr[n - l + i]);
+    SS_ASG(stats, 3 * (k + l));
+
+    size_t nlt = b - a, ngt = d - c, neq = n - nlt - ngt;
+    if (nlt > 1)
+      SS_FN(sort_rec)(arr, nlt, depth, aux, stats);
+    if (v != 0 && neq > 1)
+      SS_FN(sort_rec)(arr + nlt, neq, depth + 1, aux, stats);
+    // Loop on the greater part
+    arr += nlt + neq;
+    n = ngt;
+  }
+  if (n > 1)
+    SS_FN(insertion)(arr, n, depth, stats);
+}
+
+void SS_FN(sort_multikey)(char **arr, size_t n, SortStats *stats) {
+  if (n < 2)
+    return;
+  char **aux = n >= MSD_THRESHOLD ? malloc(n * sizeof(char *)) : NULL;
+  if (n >= MSD_THRESHOLD && !aux) {
+    // No scratch memory: comparison introsort instead
+    SS_FN(sort_quick)(arr, n, stats);
+    return;
+  }
+  SS_FN(sort_rec)(arr, n, 0, aux, stats);
+  free(aux);
+}
+
+// --- Cached-prefix sort ---
+
+static int SS_FN(prefix_less)(const PrefixEntry *a, const PrefixEntry *b,
+                              SortStats *stats) {
+  SS_CMP(stats, 1);
+  if (a->key != b->key) {
+    SS_AVD(stats, 1);
+    return a->key < b->key;
+  }
+  // Equal keys with a zero last byte: both strings ended inside the prefix
+  if ((a->key & 0xFF) == 0) {
+    SS_AVD(stats, 1);
+    return 0;
+  }
+  return strcmp(a->s + 8, b->s + 8) < 0;
+}
+
+static void SS_FN(prefix_insertion)(PrefixEntry *arr, size_t n,
+                                    SortStats *stats) {
+  for (size_t i = 1; i < n; i++) {
+    PrefixEntry key = arr[i];
+    size_t j = i;
+    while (j > 0 && SS_FN(prefix_less)(&key, &arr[j - 1], stats)) {
+      arr[j] = arr[j - 1];
+      SS_ASG(stats, 1);
+      j--;
+    }
+    arr[j] = key;
+    SS_ASG(stats, 1);
+  }
+}
+
+static void SS_FN(prefix_sift)(PrefixEntry *arr, size_t root, size_t n,
+                               SortStats *stats) {
+  for (size_t child; (child = 2 * root + 1) < n; root = child) {
+    if (child + 1 < n &&
+        SS_FN(prefix_less)(&arr[child], &arr[child + 1], stats))
+      child++;
+    if (!SS_FN(prefix_less)(&arr[root], &arr[child], stats))
+      return;
+    prefix_swap(&arr[root], &arr[child]);
+    SS_ASG(stats, 3);
+  }
+}
+
+static void SS_FN(prefix_heapsort)(PrefixEntry *arr, size_t n,
+                                   SortStats *stats) {
+  for (size_t i = n / 2; i-- > 0;)
+    SS_FN(prefix_sift)(arr, i, n, stats);
+  for (size_t end = n - 1; end > 0; end--) {
+    prefix_swap(&arr[0], &arr[end]);
+    SS_ASG(stats, 3);
+    SS_FN(prefix_sift)(arr, 0, end, stats);
+  }
+}
+
+static void SS_FN(prefix_introsort)(PrefixEntry *arr, size_t n, int depth,
+                                    SortStats *stats) {
+  while (n > PREFIX_CUTOFF) {
+    if (depth-- == 0) {
+      SS_FN(prefix_heapsort)(arr, n, stats);
+      return;
+    }
+    // Median of three to arr[0], then Hoare partition around it
+    size_t mid = n / 2;
+    if (SS_FN(prefix_less)(&arr[mid], &arr[0], stats)) {
+      prefix_swap(&arr[mid], &arr[0]);
+      SS_ASG(stats, 3);
+    }
+    if (SS_FN(prefix_less)(&arr[n - 1], &arr[0], stats)) {
+      prefix_swap(&arr[n - 1], &arr[0]);
+      SS_ASG(stats, 3);
+    }
+    if (SS_FN(prefix_less)(&arr[n - 1], &arr[mid], stats)) {
+      prefix_swap(&arr[n - 1], &arr[mid]);
+      SS_ASG(stats, 3);
+    }
+    prefix_swap(&arr[0], &arr[mid]);
+    SS_ASG(stats, 3);
+    size_t i = 0, j = n;
+    for (;;) {
+      while (SS_FN(prefix_less)(&arr[++i], &arr[0], stats))
+        if (i == n - 1)
+          break;
+      while (SS_FN(prefix_less)(&arr[0], &arr[--j], stats))
+        ;
+      if (i >= j)
+        break;
+      prefix_swap(&arr[i], &arr[j]);
+      SS_ASG(stats, 3);
+    }
+    prefix_swap(&arr[0], &arr[j]);
+    SS_ASG(stats, 3);
+    // Recurse on the smaller side, loop on the larger
+    if (j < n - j - 1) {
+      SS_FN(prefix_introsort)(arr, j, depth, stats);
+      arr += j + 1;
+      n -= j + 1;
+    } else {
+      SS_FN(prefix_introsort)(arr + j + 1, n - j - 1, depth, stats);
+      n = j;
+    }
+  }
+  SS_FN(prefix_insertion)(arr, n, stats);
+}
+
+void SS_FN(sort_prefix)(char **arr, size_t n, SortStats *stats) {
+  if (n < 2)
+    return;
+  PrefixEntry *keys = malloc(n * sizeof(PrefixEntry));
+  if (!keys) {
+    SS_FN(sort_quick)(arr, n, stats);
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    keys[i].key = load_prefix(arr[i]);
+    keys[i].s = arr[i];
+  }
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  SS_FN(prefix_introsort)(keys, n, depth, stats);
+  for (size_t i = 0; i < n; i++)
+    arr[i] = keys[i].s;
+  SS_ASG(stats, 2 * n);
+  free(keys);
+}
+
+#undef SS_CMP
+#undef SS_AVD
+#undef SS_ASG
+#undef SS_FN
+#undef SS_CAT
+#undef SS_CAT_
+#undef SS_SUFFIX
+#undef SORT_NO_STATS
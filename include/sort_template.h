@@ -0,0 +1,922 @@
+// Sort kernel template, instantiated once per element type.
+// No include guard: the includer defines, for each instantiation,
+//   SORT_T            element type (int, double, char, char *)
+//   SORT_SUFFIX       name suffix (sort_bubble_<suffix>, ...)
+//   SORT_LESS(a, b)   strict ordering on two SORT_T values
+//   SORT_NETWORK      (optional) small-block kernel such as sort_network_int
+//                     (sort_network_int_clean with SORT_NO_STATS),
+//                     used as the introsort base case when AVX2 is present
+//   SORT_NO_STATS     (optional) compile the SortStats counting out; the
+//                     stats argument is then ignored (timing builds)
+//   SORT_TRACE        (optional) bubble, insertion, shell and quick also
+//                     record their events into sort_trace_active
+// and gets sort_{bubble,insertion,shell,quick,par_quick,par_merge,natural}_
+// <suffix>, all matching SortKernel, the selection kernels
+// {select_nth,partial_sort,top_k}_<suffix> (SelectKernel), plus the
+// sort_ops_<suffix> table used by the parallel drivers. Statistics follow the
+// *_gen conventions (a swap counts as 3 assignments) so typed and generic runs
+// chart the same way.
+
+#define ST_CAT_(a, b) a##_##b
+#define ST_CAT(a, b) ST_CAT_(a, b)
+#define ST_FN(name) ST_CAT(name, SORT_SUFFIX)
+
+// Operation counters. The clean build drops them entirely, so the timed
+// loops carry no stores through the stats pointer.
+#ifdef SORT_NO_STATS
+#define ST_CMP(stats, k) ((void)(stats))
+#define ST_ASG(stats, k) ((void)(stats))
+#else
+#define ST_CMP(stats, k) ((stats)->comparisons += (k))
+#define ST_ASG(stats, k) ((stats)->assignments += (k))
+#endif
+
+// Trace events, with slot indices relative to the start of the array
+#ifdef SORT_TRACE
+#define ST_TR(op, i, j) sort_trace_emit((op), (i), (j))
+#else
+#define ST_TR(op, i, j) ((void)0)
+#endif
+
+#define ST_SWAP(a, b)                                                          \
+  do {                                                                         \
+    SORT_T st_tmp_ = (a);                                                      \
+    (a) = (b);                                                                 \
+    (b) = st_tmp_;                                                             \
+  } while (0)
+
+// 1. Bubble Sort
+void ST_FN(sort_bubble)(void *base, size_t n, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  if (n < 2)
+    return;
+  for (size_t i = 0; i < n - 1; i++) {
+    for (size_t j = 0; j < n - i - 1; j++) {
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, j + 1, j);
+      if (SORT_LESS(arr[j + 1], arr[j])) {
+        ST_SWAP(arr[j], arr[j + 1]);
+        ST_ASG(stats, 3);
+        ST_TR(TRACE_SWAP, j, j + 1);
+      }
+    }
+  }
+}
+
+// 2. Insertion Sort
+void ST_FN(sort_insertion)(void *base, size_t n, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  for (size_t i = 1; i < n; i++) {
+    SORT_T key = arr[i];
+    size_t j = i;
+    ST_TR(TRACE_MOVE, TRACE_TEMP, i);
+    while (j > 0) {
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, TRACE_TEMP, j - 1);
+      if (SORT_LESS(key, arr[j - 1])) {
+        arr[j] = arr[j - 1];
+        ST_ASG(stats, 1);
+        ST_TR(TRACE_MOVE, j, j - 1);
+        j--;
+      } else
+        break;
+    }
+    arr[j] = key;
+    ST_ASG(stats, 1);
+    ST_TR(TRACE_MOVE, j, TRACE_TEMP);
+  }
+}
+
+// 3. Shell Sort
+void ST_FN(sort_shell)(void *base, size_t n, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  for (size_t gap = n / 2; gap > 0; gap /= 2) {
+    for (size_t i = gap; i < n; i++) {
+      SORT_T temp = arr[i];
+      size_t j;
+      ST_TR(TRACE_MOVE, TRACE_TEMP, i);
+      for (j = i; j >= gap; j -= gap) {
+        ST_CMP(stats, 1);
+        ST_TR(TRACE_CMP, TRACE_TEMP, j - gap);
+        if (SORT_LESS(temp, arr[j - gap])) {
+          arr[j] = arr[j - gap];
+          ST_ASG(stats, 1);
+          ST_TR(TRACE_MOVE, j, j - gap);
+        } else
+          break;
+      }
+      arr[j] = temp;
+      ST_TR(TRACE_MOVE, j, TRACE_TEMP);
+    }
+  }
+}
+
+// 4. Quick Sort (same introsort as sort_quick_gen)
+static void ST_FN(insertion_range)(SORT_T *arr, size_t lo, size_t hi,
+                                   SortStats *stats) {
+  for (size_t i = lo + 1; i < hi; i++) {
+    SORT_T key = arr[i];
+    size_t j = i;
+    ST_TR(TRACE_MOVE, TRACE_TEMP, i);
+    while (j > lo) {
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, TRACE_TEMP, j - 1);
+      if (SORT_LESS(key, arr[j - 1])) {
+        arr[j] = arr[j - 1];
+        ST_ASG(stats, 1);
+        ST_TR(TRACE_MOVE, j, j - 1);
+        j--;
+      } else
+        break;
+    }
+    arr[j] = key;
+    ST_ASG(stats, 1);
+    ST_TR(TRACE_MOVE, j, TRACE_TEMP);
+  }
+}
+
+// Heap over arr[lo..lo + n)
+static void ST_FN(sift_down)(SORT_T *arr, size_t lo, size_t root, size_t n,
+                             SortStats *stats) {
+  SORT_T *h = arr + lo;
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= n)
+      return;
+    if (child + 1 < n) {
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, lo + child, lo + child + 1);
+      if (SORT_LESS(h[child], h[child + 1]))
+        child++;
+    }
+    ST_CMP(stats, 1);
+    ST_TR(TRACE_CMP, lo + root, lo + child);
+    if (!SORT_LESS(h[root], h[child]))
+      return;
+    ST_SWAP(h[root], h[child]);
+    ST_ASG(stats, 3);
+    ST_TR(TRACE_SWAP, lo + root, lo + child);
+    root = child;
+  }
+}
+
+static void ST_FN(heap_range)(SORT_T *arr, size_t lo, size_t n,
+                              SortStats *stats) {
+  for (size_t i = n / 2; i > 0; i--)
+    ST_FN(sift_down)(arr, lo, i - 1, n, stats);
+  for (size_t end = n - 1; end > 0; end--) {
+    ST_SWAP(arr[lo], arr[lo + end]);
+    ST_ASG(stats, 3);
+    ST_TR(TRACE_SWAP, lo, lo + end);
+    ST_FN(sift_down)(arr, lo, 0, end, stats);
+  }
+}
+
+static size_t ST_FN(median3)(SORT_T *arr, size_t a, size_t b, size_t c,
+                             SortStats *stats) {
+  ST_CMP(stats, 2);
+  ST_TR(TRACE_CMP, a, b);
+  if (SORT_LESS(arr[a], arr[b])) {
+    ST_TR(TRACE_CMP, b, c);
+    if (SORT_LESS(arr[b], arr[c]))
+      return b;
+    ST_CMP(stats, 1);
+    ST_TR(TRACE_CMP, a, c);
+    return SORT_LESS(arr[a], arr[c]) ? c : a;
+  }
+  ST_TR(TRACE_CMP, a, c);
+  if (SORT_LESS(arr[a], arr[c]))
+    return a;
+  ST_CMP(stats, 1);
+  ST_TR(TRACE_CMP, b, c);
+  return SORT_LESS(arr[b], arr[c]) ? c : b;
+}
+
+static size_t ST_FN(partition)(SORT_T *arr, size_t lo, size_t hi,
+                               SortStats *stats) {
+  size_t n = hi - lo, mid = lo + n / 2, p;
+  if (n < 128) {
+    p = ST_FN(median3)(arr, lo, mid, hi - 1, stats);
+  } else {
+    size_t s = n / 8;
+    size_t a = ST_FN(median3)(arr, lo, lo + s, lo + 2 * s, stats);
+    size_t b = ST_FN(median3)(arr, mid - s, mid, mid + s, stats);
+    size_t c = ST_FN(median3)(arr, hi - 1 - 2 * s, hi - 1 - s, hi - 1, stats);
+    p = ST_FN(median3)(arr, a, b, c, stats);
+  }
+  ST_SWAP(arr[lo], arr[p]);
+  ST_ASG(stats, 3);
+  ST_TR(TRACE_SWAP, lo, p);
+  SORT_T pivot = arr[lo]; // Stays in slot lo until the final swap
+
+  size_t i = lo, j = hi;
+  for (;;) {
+    do {
+      i++;
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, i, lo);
+    } while (i < hi - 1 && SORT_LESS(arr[i], pivot));
+    do {
+      j--;
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, lo, j);
+    } while (SORT_LESS(pivot, arr[j]));
+    if (i >= j)
+      break;
+    ST_SWAP(arr[i], arr[j]);
+    ST_ASG(stats, 3);
+    ST_TR(TRACE_SWAP, i, j);
+  }
+  ST_SWAP(arr[lo], arr[j]);
+  ST_ASG(stats, 3);
+  ST_TR(TRACE_SWAP, lo, j);
+  return j;
+}
+
+#ifdef SORT_NETWORK
+#define ST_CUTOFF (sort_network_available() ? SORT_NETWORK_MAX : 16)
+#else
+#define ST_CUTOFF 16
+#endif
+
+static void ST_FN(introsort)(SORT_T *arr, size_t lo, size_t hi, int depth,
+                             SortStats *stats) {
+  size_t cutoff = ST_CUTOFF;
+  while (hi - lo > cutoff) {
+    if (depth == 0) {
+      ST_FN(heap_range)(arr, lo, hi - lo, stats);
+      return;
+    }
+    depth--;
+    size_t p = ST_FN(partition)(arr, lo, hi, stats);
+    if (p - lo < hi - p - 1) {
+      ST_FN(introsort)(arr, lo, p, depth, stats);
+      lo = p + 1;
+    } else {
+      ST_FN(introsort)(arr, p + 1, hi, depth, stats);
+      hi = p;
+    }
+  }
+#ifdef SORT_NETWORK
+  if (cutoff > 16) {
+    SORT_NETWORK(arr + lo, hi - lo, stats);
+    return;
+  }
+#endif
+  ST_FN(insertion_range)(arr, lo, hi, stats);
+}
+
+void ST_FN(sort_quick)(void *base, size_t n, SortStats *stats) {
+  if (n < 2)
+    return;
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  ST_FN(introsort)((SORT_T *)base, 0, n, depth, stats);
+}
+
+// --- Building blocks for the parallel drivers (sort_parallel.c) ---
+
+static size_t ST_FN(ops_partition)(void *base, size_t lo, size_t hi,
+                                   SortStats *stats) {
+  return ST_FN(partition)((SORT_T *)base, lo, hi, stats);
+}
+
+// Merges two sorted runs into out, which must not overlap either input
+static void ST_FN(ops_merge)(const void *a, size_t na, const void *b,
+                             size_t nb, void *out, SortStats *stats) {
+  SORT_T *x = (SORT_T *)a;
+  SORT_T *y = (SORT_T *)b;
+  SORT_T *o = (SORT_T *)out;
+  size_t i = 0, j = 0, k = 0;
+  while (i < na && j < nb) {
+    ST_CMP(stats, 1);
+    if (SORT_LESS(y[j], x[i]))
+      o[k++] = y[j++];
+    else
+      o[k++] = x[i++];
+  }
+  while (i < na)
+    o[k++] = x[i++];
+  while (j < nb)
+    o[k++] = y[j++];
+  ST_ASG(stats, na + nb);
+}
+
+// Index of the first element of run that is not less than *key
+static size_t ST_FN(ops_lower_bound)(const void *run, size_t n,
+                                     const void *key) {
+  SORT_T *r = (SORT_T *)run;
+  SORT_T k = *(SORT_T *)key;
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (SORT_LESS(r[mid], k))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// Index of the first element of run that is greater than *key
+static size_t ST_FN(ops_upper_bound)(const void *run, size_t n,
+                                     const void *key) {
+  SORT_T *r = (SORT_T *)run;
+  SORT_T k = *(SORT_T *)key;
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (SORT_LESS(k, r[mid]))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+const SortOps ST_FN(sort_ops) = {sizeof(SORT_T), ST_FN(ops_partition),
+                                 ST_FN(sort_quick), ST_FN(ops_merge),
+                                 ST_FN(ops_lower_bound),
+                                 ST_FN(ops_upper_bound)};
+
+// 5. Parallel Quick Sort / 6. Parallel Merge Sort
+void ST_FN(sort_par_quick)(void *base, size_t n, SortStats *stats) {
+  sort_parallel_quick(base, n, &ST_FN(sort_ops), stats);
+}
+
+void ST_FN(sort_par_merge)(void *base, size_t n, SortStats *stats) {
+  sort_parallel_merge(base, n, &ST_FN(sort_ops), stats);
+}
+
+// 7. Natural Merge Sort (Timsort-style)
+// Detects ascending and strictly descending runs (the latter reversed in
+// place), extends runs shorter than minrun with binary insertion, keeps the
+// pending runs balanced on a stack and merges them through one buffer of
+// n/2 elements with galloping. Stable, O(n) on presorted input.
+
+#define ST_MIN_GALLOP 7
+#define ST_MAX_RUNS 85 // Enough for 2^64 elements under the stack invariants
+
+typedef struct {
+  SORT_T *buf; // Scratch for the shorter run of a merge
+  size_t min_gallop;
+  SortStats *stats;
+  size_t nruns;
+  size_t start[ST_MAX_RUNS], len[ST_MAX_RUNS];
+} ST_FN(MergeState);
+
+// First index k of a[0..n) with !(a[k] < key), galloping out from hint
+static size_t ST_FN(gallop_left)(SORT_T key, SORT_T *a, size_t n, size_t hint,
+                                 SortStats *stats) {
+  ptrdiff_t last = 0, ofs = 1, h = (ptrdiff_t)hint;
+  ST_CMP(stats, 1);
+  if (SORT_LESS(a[h], key)) {
+    // a[h + last] < key <= a[h + ofs]
+    ptrdiff_t max = (ptrdiff_t)n - h;
+    while (ofs < max) {
+      ST_CMP(stats, 1);
+      if (!SORT_LESS(a[h + ofs], key))
+        break;
+      last = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max)
+      ofs = max;
+    last += h;
+    ofs += h;
+  } else {
+    // a[h - ofs] < key <= a[h - last]
+    ptrdiff_t max = h + 1;
+    while (ofs < max) {
+      ST_CMP(stats, 1);
+      if (SORT_LESS(a[h - ofs], key))
+        break;
+      last = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max)
+      ofs = max;
+    ptrdiff_t t = last;
+    last = h - ofs;
+    ofs = h - t;
+  }
+  // a[last] < key <= a[ofs], finish with a binary search
+  last++;
+  while (last < ofs) {
+    ptrdiff_t m = last + ((ofs - last) >> 1);
+    ST_CMP(stats, 1);
+    if (SORT_LESS(a[m], key))
+      last = m + 1;
+    else
+      ofs = m;
+  }
+  return (size_t)ofs;
+}
+
+// First index k of a[0..n) with key < a[k], galloping out from hint
+static size_t ST_FN(gallop_right)(SORT_T key, SORT_T *a, size_t n,
+                                  size_t hint, SortStats *stats) {
+  ptrdiff_t last = 0, ofs = 1, h = (ptrdiff_t)hint;
+  ST_CMP(stats, 1);
+  if (SORT_LESS(key, a[h])) {
+    // a[h - ofs] <= key < a[h - last]
+    ptrdiff_t max = h + 1;
+    while (ofs < max) {
+      ST_CMP(stats, 1);
+      if (!SORT_LESS(key, a[h - ofs]))
+        break;
+      last = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max)
+      ofs = max;
+    ptrdiff_t t = last;
+    last = h - ofs;
+    ofs = h - t;
+  } else {
+    // a[h + last] <= key < a[h + ofs]
+    ptrdiff_t max = (ptrdiff_t)n - h;
+    while (ofs < max) {
+      ST_CMP(stats, 1);
+      if (SORT_LESS(key, a[h + ofs]))
+        break;
+      last = ofs;
+      ofs = (ofs << 1) + 1;
+    }
+    if (ofs > max)
+      ofs = max;
+    last += h;
+    ofs += h;
+  }
+  last++;
+  while (last < ofs) {
+    ptrdiff_t m = last + ((ofs - last) >> 1);
+    ST_CMP(stats, 1);
+    if (SORT_LESS(key, a[m]))
+      ofs = m;
+    else
+      last = m + 1;
+  }
+  return (size_t)ofs;
+}
+
+// Sorts [lo, hi) knowing [lo, start) is already sorted
+static void ST_FN(binary_insertion)(SORT_T *arr, size_t lo, size_t hi,
+                                    size_t start, SortStats *stats) {
+  for (size_t i = start; i < hi; i++) {
+    SORT_T pivot = arr[i];
+    size_t l = lo, r = i;
+    while (l < r) {
+      size_t m = l + (r - l) / 2;
+      ST_CMP(stats, 1);
+      if (SORT_LESS(pivot, arr[m]))
+        r = m;
+      else
+        l = m + 1;
+    }
+    for (size_t j = i; j > l; j--)
+      arr[j] = arr[j - 1];
+    arr[l] = pivot;
+    ST_ASG(stats, i - l + 1);
+  }
+}
+
+// Length of the run starting at lo; a strictly descending run is reversed
+static size_t ST_FN(count_run)(SORT_T *arr, size_t lo, size_t hi,
+                               SortStats *stats) {
+  size_t i = lo + 1;
+  if (i == hi)
+    return 1;
+  ST_CMP(stats, 1);
+  if (SORT_LESS(arr[i], arr[lo])) {
+    i++;
+    while (i < hi) {
+      ST_CMP(stats, 1);
+      if (!SORT_LESS(arr[i], arr[i - 1]))
+        break;
+      i++;
+    }
+    for (size_t a = lo, b = i - 1; a < b; a++, b--) {
+      ST_SWAP(arr[a], arr[b]);
+      ST_ASG(stats, 3);
+    }
+  } else {
+    i++;
+    while (i < hi) {
+      ST_CMP(stats, 1);
+      if (SORT_LESS(arr[i], arr[i - 1]))
+        break;
+      i++;
+    }
+  }
+  return i - lo;
+}
+
+// Merges a[0..na) and b[0..nb) (b follows a) with na <= nb. merge_at already
+// trimmed both runs: b[0] comes first and a[na-1] comes last.
+static void ST_FN(merge_lo)(ST_FN(MergeState) *ms, SORT_T *a, size_t na,
+                            SORT_T *b, size_t nb) {
+  SortStats *stats = ms->stats;
+  SORT_T *pa = ms->buf;
+  SORT_T *pb = b;
+  SORT_T *dest = a;
+  for (size_t i = 0; i < na; i++)
+    pa[i] = a[i];
+  ST_ASG(stats, na);
+
+  *dest++ = *pb++;
+  ST_ASG(stats, 1);
+  if (--nb == 0)
+    goto done;
+  if (na == 1)
+    goto last_a;
+
+  for (;;) {
+    size_t acount = 0, bcount = 0;
+    // One-at-a-time until one side wins min_gallop times in a row
+    for (;;) {
+      ST_CMP(stats, 1);
+      ST_ASG(stats, 1);
+      if (SORT_LESS(*pb, *pa)) {
+        *dest++ = *pb++;
+        bcount++;
+        acount = 0;
+        if (--nb == 0)
+          goto done;
+        if (bcount >= ms->min_gallop)
+          break;
+      } else {
+        *dest++ = *pa++;
+        acount++;
+        bcount = 0;
+        if (--na == 1)
+          goto last_a;
+        if (acount >= ms->min_gallop)
+          break;
+      }
+    }
+    // Galloping: copy whole blocks while they stay long
+    ms->min_gallop++;
+    do {
+      ms->min_gallop -= ms->min_gallop > 1;
+      size_t k = ST_FN(gallop_right)(*pb, pa, na, 0, stats);
+      acount = k;
+      for (size_t i = 0; i < k; i++)
+        *dest++ = *pa++;
+      ST_ASG(stats, k);
+      na -= k;
+      if (na == 1)
+        goto last_a;
+      if (na == 0)
+        goto done;
+      *dest++ = *pb++;
+      ST_ASG(stats, 1);
+      if (--nb == 0)
+        goto done;
+
+      k = ST_FN(gallop_left)(*pa, pb, nb, 0, stats);
+      bcount = k;
+      for (size_t i = 0; i < k; i++)
+        *dest++ = *pb++;
+      ST_ASG(stats, k);
+      nb -= k;
+      if (nb == 0)
+        goto done;
+      *dest++ = *pa++;
+      ST_ASG(stats, 1);
+      if (--na == 1)
+        goto last_a;
+    } while (acount >= ST_MIN_GALLOP || bcount >= ST_MIN_GALLOP);
+    ms->min_gallop++;
+  }
+
+done:
+  for (size_t i = 0; i < na; i++)
+    dest[i] = pa[i];
+  ST_ASG(stats, na);
+  return;
+last_a:
+  // The last element of a goes after the rest of b
+  for (size_t i = 0; i < nb; i++)
+    dest[i] = pb[i];
+  dest[nb] = *pa;
+  ST_ASG(stats, nb + 1);
+}
+
+// Mirror of merge_lo for na >= nb: buffers b and merges from the right
+static void ST_FN(merge_hi)(ST_FN(MergeState) *ms, SORT_T *a, size_t na,
+                            SORT_T *b, size_t nb) {
+  SortStats *stats = ms->stats;
+  for (size_t i = 0; i < nb; i++)
+    ms->buf[i] = b[i];
+  ST_ASG(stats, nb);
+  SORT_T *dest = b + nb - 1;
+  SORT_T *pa = a + na - 1;
+  SORT_T *pb = ms->buf + nb - 1;
+
+  *dest-- = *pa--;
+  ST_ASG(stats, 1);
+  if (--na == 0)
+    goto done;
+  if (nb == 1)
+    goto first_b;
+
+  for (;;) {
+    size_t acount = 0, bcount = 0;
+    for (;;) {
+      ST_CMP(stats, 1);
+      ST_ASG(stats, 1);
+      if (SORT_LESS(*pb, *pa)) {
+        *dest-- = *pa--;
+        acount++;
+        bcount = 0;
+        if (--na == 0)
+          goto done;
+        if (acount >= ms->min_gallop)
+          break;
+      } else {
+        *dest-- = *pb--;
+        bcount++;
+        acount = 0;
+        if (--nb == 1)
+          goto first_b;
+        if (bcount >= ms->min_gallop)
+          break;
+      }
+    }
+    ms->min_gallop++;
+    do {
+      ms->min_gallop -= ms->min_gallop > 1;
+      size_t k = na - ST_FN(gallop_right)(*pb, a, na, na - 1, stats);
+      acount = k;
+      for (size_t i = 0; i < k; i++)
+        *dest-- = *pa--;
+      ST_ASG(stats, k);
+      na -= k;
+      if (na == 0)
+        goto done;
+      *dest-- = *pb--;
+      ST_ASG(stats, 1);
+      if (--nb == 1)
+        goto first_b;
+
+      k = nb - ST_FN(gallop_left)(*pa, ms->buf, nb, nb - 1, stats);
+      bcount = k;
+      for (size_t i = 0; i < k; i++)
+        *dest-- = *pb--;
+      ST_ASG(stats, k);
+      nb -= k;
+      if (nb == 1)
+        goto first_b;
+      if (nb == 0)
+        goto done;
+      *dest-- = *pa--;
+      ST_ASG(stats, 1);
+      if (--na == 0)
+        goto done;
+    } while (acount >= ST_MIN_GALLOP || bcount >= ST_MIN_GALLOP);
+    ms->min_gallop++;
+  }
+
+done:
+  for (size_t i = 0; i < nb; i++)
+    dest[-(ptrdiff_t)i] = pb[-(ptrdiff_t)i];
+  ST_ASG(stats, nb);
+  return;
+first_b:
+  // The first element of b goes before the rest of a
+  for (size_t i = 0; i < na; i++)
+    *dest-- = *pa--;
+  *dest = *pb;
+  ST_ASG(stats, na + 1);
+}
+
+// Merges pending runs i and i + 1
+static void ST_FN(merge_at)(ST_FN(MergeState) *ms, SORT_T *arr, size_t i) {
+  SORT_T *a = arr + ms->start[i];
+  SORT_T *b = arr + ms->start[i + 1];
+  size_t na = ms->len[i], nb = ms->len[i + 1];
+  ms->len[i] = na + nb;
+  for (size_t k = i + 1; k + 1 < ms->nruns; k++) {
+    ms->start[k] = ms->start[k + 1];
+    ms->len[k] = ms->len[k + 1];
+  }
+  ms->nruns--;
+
+  // Elements of a before b[0] and of b after a[na-1] are already in place
+  size_t k = ST_FN(gallop_right)(b[0], a, na, 0, ms->stats);
+  a += k;
+  na -= k;
+  if (na == 0)
+    return;
+  nb = ST_FN(gallop_left)(a[na - 1], b, nb, nb - 1, ms->stats);
+  if (nb == 0)
+    return;
+  if (na <= nb)
+    ST_FN(merge_lo)(ms, a, na, b, nb);
+  else
+    ST_FN(merge_hi)(ms, a, na, b, nb);
+}
+
+// Restores len[i-2] > len[i-1] + len[i] and len[i-1] > len[i] on the stack
+static void ST_FN(merge_collapse)(ST_FN(MergeState) *ms, SORT_T *arr) {
+  size_t *len = ms->len;
+  while (ms->nruns > 1) {
+    size_t n = ms->nruns - 2;
+    if ((n > 0 && len[n - 1] <= len[n] + len[n + 1]) ||
+        (n > 1 && len[n - 2] <= len[n - 1] + len[n])) {
+      if (len[n - 1] < len[n + 1])
+        n--;
+      ST_FN(merge_at)(ms, arr, n);
+    } else if (len[n] <= len[n + 1]) {
+      ST_FN(merge_at)(ms, arr, n);
+    } else
+      break;
+  }
+}
+
+void ST_FN(sort_natural)(void *base, size_t n, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  if (n < 2)
+    return;
+  if (n < 64) {
+    size_t run = ST_FN(count_run)(arr, 0, n, stats);
+    ST_FN(binary_insertion)(arr, 0, n, run, stats);
+    return;
+  }
+
+  ST_FN(MergeState) ms;
+  ms.buf = malloc((n / 2 + 1) * sizeof(SORT_T));
+  if (!ms.buf) {
+    ST_FN(sort_quick)(base, n, stats);
+    return;
+  }
+  ms.min_gallop = ST_MIN_GALLOP;
+  ms.stats = stats;
+  ms.nruns = 0;
+
+  // minrun in [32, 64] such that n / minrun is (close to) a power of two
+  size_t minrun = n, r = 0;
+  while (minrun >= 64) {
+    r |= minrun & 1;
+    minrun >>= 1;
+  }
+  minrun += r;
+
+  for (size_t lo = 0; lo < n;) {
+    size_t run = ST_FN(count_run)(arr, lo, n, stats);
+    if (run < minrun) {
+      size_t force = n - lo < minrun ? n - lo : minrun;
+      ST_FN(binary_insertion)(arr, lo, lo + force, lo + run, stats);
+      run = force;
+    }
+    ms.start[ms.nruns] = lo;
+    ms.len[ms.nruns] = run;
+    ms.nruns++;
+    ST_FN(merge_collapse)(&ms, arr);
+    lo += run;
+  }
+  while (ms.nruns > 1) {
+    size_t i = ms.nruns - 2;
+    if (i > 0 && ms.len[i - 1] < ms.len[i + 1])
+      i--;
+    ST_FN(merge_at)(&ms, arr, i);
+  }
+  free(ms.buf);
+}
+
+// --- Selection ---
+
+// Introselect fallback once the depth budget is spent: a max-heap of the
+// k - lo + 1 smallest elements seen, built over arr[lo..k], then its root
+// (the element of rank k) is moved to slot k
+static void ST_FN(heap_select)(SORT_T *arr, size_t lo, size_t hi, size_t k,
+                               SortStats *stats) {
+  size_t m = k - lo + 1;
+  for (size_t i = m / 2; i > 0; i--)
+    ST_FN(sift_down)(arr, lo, i - 1, m, stats);
+  for (size_t i = k + 1; i < hi; i++) {
+    ST_CMP(stats, 1);
+    ST_TR(TRACE_CMP, i, lo);
+    if (SORT_LESS(arr[i], arr[lo])) {
+      ST_SWAP(arr[lo], arr[i]);
+      ST_ASG(stats, 3);
+      ST_TR(TRACE_SWAP, lo, i);
+      ST_FN(sift_down)(arr, lo, 0, m, stats);
+    }
+  }
+  ST_SWAP(arr[lo], arr[k]);
+  ST_ASG(stats, 3);
+  ST_TR(TRACE_SWAP, lo, k);
+}
+
+// 8. Introselect: the introsort partition, continuing only into the side
+// that holds rank k (O(n) expected), heap select after 2*log2(n) partitions
+void ST_FN(select_nth)(void *base, size_t n, size_t k, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  if (k >= n)
+    return;
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  size_t lo = 0, hi = n;
+  while (hi - lo > 16) {
+    if (depth == 0) {
+      ST_FN(heap_select)(arr, lo, hi, k, stats);
+      return;
+    }
+    depth--;
+    size_t p = ST_FN(partition)(arr, lo, hi, stats);
+    if (k == p)
+      return;
+    if (k < p)
+      hi = p;
+    else
+      lo = p + 1;
+  }
+  ST_FN(insertion_range)(arr, lo, hi, stats);
+}
+
+// 9. Partial sort: the k smallest, sorted, in arr[0..k); O(n + k log k)
+void ST_FN(partial_sort)(void *base, size_t n, size_t k, SortStats *stats) {
+  if (k >= n) {
+    ST_FN(sort_quick)(base, n, stats);
+    return;
+  }
+  if (k == 0)
+    return;
+  ST_FN(select_nth)(base, n, k - 1, stats);
+  ST_FN(sort_quick)(base, k - 1, stats); // arr[k - 1] is already in place
+}
+
+// Min-heap over arr[0..n)
+static void ST_FN(min_sift_down)(SORT_T *arr, size_t root, size_t n,
+                                 SortStats *stats) {
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= n)
+      return;
+    if (child + 1 < n) {
+      ST_CMP(stats, 1);
+      ST_TR(TRACE_CMP, child + 1, child);
+      if (SORT_LESS(arr[child + 1], arr[child]))
+        child++;
+    }
+    ST_CMP(stats, 1);
+    ST_TR(TRACE_CMP, child, root);
+    if (!SORT_LESS(arr[child], arr[root]))
+      return;
+    ST_SWAP(arr[root], arr[child]);
+    ST_ASG(stats, 3);
+    ST_TR(TRACE_SWAP, root, child);
+    root = child;
+  }
+}
+
+// 10. Top-k: the k largest, largest first, in arr[0..k). One pass with a
+// bounded min-heap in arr[0..k) whose root is the smallest kept value, so
+// most elements cost one comparison; O(n log k).
+void ST_FN(top_k)(void *base, size_t n, size_t k, SortStats *stats) {
+  SORT_T *arr = (SORT_T *)base;
+  if (k > n)
+    k = n;
+  if (k == 0)
+    return;
+  for (size_t i = k / 2; i > 0; i--)
+    ST_FN(min_sift_down)(arr, i - 1, k, stats);
+  for (size_t i = k; i < n; i++) {
+    ST_CMP(stats, 1);
+    ST_TR(TRACE_CMP, 0, i);
+    if (SORT_LESS(arr[0], arr[i])) {
+      ST_SWAP(arr[0], arr[i]);
+      ST_ASG(stats, 3);
+      ST_TR(TRACE_SWAP, 0, i);
+      ST_FN(min_sift_down)(arr, 0, k, stats);
+    }
+  }
+  // Popping the minimum to the back leaves the heap in descending order
+  for (size_t end = k - 1; end > 0; end--) {
+    ST_SWAP(arr[0], arr[end]);
+    ST_ASG(stats, 3);
+    ST_TR(TRACE_SWAP, 0, end);
+    ST_FN(min_sift_down)(arr, 0, end, stats);
+  }
+}
+
+#undef ST_CUTOFF
+#undef ST_MIN_GALLOP
+#undef ST_MAX_RUNS
+#undef ST_SWAP
+#undef ST_TR
+#undef ST_CMP
+#undef ST_ASG
+#undef ST_FN
+#undef ST_CAT
+#undef ST_CAT_
+#undef SORT_T
+#undef SORT_SUFFIX
+#undef SORT_LESS
+#undef SORT_NETWORK
+#undef SORT_NO_STATS
+#undef SORT_TRACE
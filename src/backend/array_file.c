@@ -0,0 +1,217 @@
+#include "backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary array files: the elements as they sit in memory, so a load is a
+// mapping of the file instead of a parse. Layout, little-endian:
+//   0  magic "SORTARR\0"
+//   8  uint32 version (ARRAY_FILE_VERSION)
+//   12 uint32 DataType
+//   16 uint64 element count n
+//   24 uint64 payload bytes
+//   32 payload: n ints (32-bit), doubles (IEEE 754) or chars; for strings,
+//      n + 1 uint64 offsets into the blob that follows (the last one is the
+//      blob size), then the NUL-terminated strings back to back.
+// The mapping is private and writable: pages the caller writes to are
+// copied on first write, the file itself never changes.
+
+#define ARRAY_FILE_VERSION 1
+#define HEADER_SIZE 32
+
+static const char MAGIC[8] = "SORTARR";
+
+// The payload is the in-memory representation, read as is
+#if (defined(__BYTE_ORDER__) &&                                               \
+     __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ||                             \
+    defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+#define NATIVE_LAYOUT 1
+#else
+#define NATIVE_LAYOUT 0
+#endif
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t type;
+  uint64_t count;
+  uint64_t payload;
+} FileHeader;
+
+int array_file_detect(const char *path) {
+  char magic[sizeof(MAGIC)];
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return 0;
+  int found = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+              memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  fclose(f);
+  return found;
+}
+
+int array_file_save(const char *path, const void *arr, size_t n,
+                    DataType t) {
+  if (!NATIVE_LAYOUT || t >= TYPE_CUSTOM || (n > 0 && !arr))
+    return -1;
+  FileHeader h;
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = ARRAY_FILE_VERSION;
+  h.type = (uint32_t)t;
+  h.count = n;
+
+  // Strings: the offsets table is built first, as the header needs the
+  // blob size
+  uint64_t *offsets = NULL;
+  if (t == TYPE_STRING) {
+    offsets = malloc((n + 1) * sizeof(uint64_t));
+    if (!offsets)
+      return -1;
+    uint64_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+      offsets[i] = pos;
+      pos += strlen(((char *const *)arr)[i]) + 1;
+    }
+    offsets[n] = pos;
+    h.payload = (n + 1) * sizeof(uint64_t) + pos;
+  } else {
+    h.payload = (uint64_t)n * get_element_size(t);
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    free(offsets);
+    return -1;
+  }
+  int ok = fwrite(&h, HEADER_SIZE, 1, f) == 1;
+  if (t != TYPE_STRING) {
+    // The array in one block, straight from memory
+    ok = ok && (n == 0 || fwrite(arr, (size_t)h.payload, 1, f) == 1);
+  } else {
+    ok = ok && fwrite(offsets, sizeof(uint64_t), n + 1, f) == n + 1;
+    for (size_t i = 0; ok && i < n; i++) {
+      size_t len = (size_t)(offsets[i + 1] - offsets[i]);
+      ok = fwrite(((char *const *)arr)[i], 1, len, f) == len;
+    }
+  }
+  free(offsets);
+  ok = fclose(f) == 0 && ok;
+  return ok ? 0 : -1;
+}
+
+// Private writable mapping of the whole file, in *map / *len
+static int map_file(const char *path, void **map, size_t *len) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return -1;
+  LARGE_INTEGER size;
+  HANDLE mapping = NULL;
+  if (GetFileSizeEx(file, &size) && size.QuadPart >= HEADER_SIZE &&
+      (uint64_t)size.QuadPart <= (size_t)-1)
+    mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if (!mapping)
+    return -1;
+  // The view keeps the mapping object alive
+  *map = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  CloseHandle(mapping);
+  *len = (size_t)size.QuadPart;
+  return *map ? 0 : -1;
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat st;
+  void *p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size >= HEADER_SIZE &&
+      (uint64_t)st.st_size <= (size_t)-1)
+    p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+             fd, 0);
+  close(fd); // The mapping keeps the file open
+  if (p == MAP_FAILED)
+    return -1;
+  *map = p;
+  *len = (size_t)st.st_size;
+  return 0;
+#endif
+}
+
+static void unmap_file(void *map, size_t len) {
+#ifdef _WIN32
+  (void)len;
+  UnmapViewOfFile(map);
+#else
+  munmap(map, len);
+#endif
+}
+
+// Pointer table of a string payload, after checking every offset and
+// terminator against the mapping; NULL when malformed or out of memory
+static char **string_table(char *payload, uint64_t count, uint64_t bytes) {
+  if (count >= bytes / sizeof(uint64_t))
+    return NULL; // Offsets table larger than the payload
+  const uint64_t *offsets = (const uint64_t *)payload;
+  char *blob = payload + (count + 1) * sizeof(uint64_t);
+  uint64_t blob_len = bytes - (count + 1) * sizeof(uint64_t);
+  if (offsets[count] != blob_len)
+    return NULL;
+  char **table = malloc((count > 0 ? count : 1) * sizeof(char *));
+  if (!table)
+    return NULL;
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t lo = offsets[i], hi = offsets[i + 1];
+    if (hi <= lo || hi > blob_len || blob[hi - 1] != 0) {
+      free(table);
+      return NULL;
+    }
+    table[i] = blob + lo;
+  }
+  return table;
+}
+
+int array_file_open(const char *path, ArrayFile *af) {
+  memset(af, 0, sizeof(*af));
+  if (!NATIVE_LAYOUT || map_file(path, &af->map, &af->map_len) != 0)
+    return -1;
+  FileHeader h;
+  memcpy(&h, af->map, HEADER_SIZE);
+  char *payload = (char *)af->map + HEADER_SIZE;
+  int valid = memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              h.version == ARRAY_FILE_VERSION && h.type < TYPE_CUSTOM &&
+              h.payload <= af->map_len - HEADER_SIZE;
+  if (valid && h.type != TYPE_STRING)
+    valid = h.count <= h.payload / get_element_size(h.type) &&
+            h.count * get_element_size(h.type) == h.payload;
+  if (valid && h.type == TYPE_STRING) {
+    af->array = string_table(payload, h.count, h.payload);
+    af->owns_array = 1;
+    valid = af->array != NULL;
+  } else if (valid) {
+    af->array = payload; // Used in place
+  }
+  if (!valid) {
+    unmap_file(af->map, af->map_len);
+    memset(af, 0, sizeof(*af));
+    return -1;
+  }
+  af->count = (size_t)h.count;
+  af->type = (DataType)h.type;
+  return 0;
+}
+
+void array_file_close(ArrayFile *af) {
+  if (af->owns_array)
+    free(af->array);
+  if (af->map)
+    unmap_file(af->map, af->map_len);
+  memset(af, 0, sizeof(*af));
+}
@@ -0,0 +1,150 @@
+#include "backend.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Benchmark core shared by the sort/list tabs and sorter_bench: monotonic
+// wall clock, warmup, repetitions bounded by count and time budget, and
+// order statistics over the samples. Optionally, hardware counters
+// (perf_counters.c) are read around every run.
+
+double bench_now_ms(void) {
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (freq.QuadPart == 0)
+    QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+void bench_default_options(BenchOptions *opt) {
+  opt->warmup = 1;
+  opt->min_reps = 3;
+  opt->max_reps = 15;
+  opt->budget_ms = 250.0;
+  opt->cancel = NULL;
+  opt->hw_counters = 0;
+}
+
+static int cmp_sample(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// Order statistics of n samples (sorted in place)
+static void summarize(double *samples, int n, BenchResult *out) {
+  memset(out, 0, sizeof(*out));
+  out->reps = n;
+  if (n == 0)
+    return;
+  qsort(samples, n, sizeof(double), cmp_sample);
+  double sum = 0;
+  for (int i = 0; i < n; i++)
+    sum += samples[i];
+  out->mean = sum / n;
+  double var = 0;
+  for (int i = 0; i < n; i++)
+    var += (samples[i] - out->mean) * (samples[i] - out->mean);
+  out->stddev = n > 1 ? sqrt(var / (n - 1)) : 0;
+  out->min = samples[0];
+  out->median = n % 2 ? samples[n / 2]
+                      : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  int rank = (int)ceil(0.95 * n) - 1; // Nearest-rank percentile
+  out->p95 = samples[rank < 0 ? 0 : rank];
+}
+
+static int is_cancelled(const BenchOptions *opt) {
+  return opt->cancel && atomic_load(opt->cancel);
+}
+
+// One run after setup, in ms. With hc, the counters are read around it:
+// the values go to hw, the mask of valid ones to *got.
+static double timed_run(BenchFunc setup, BenchFunc run, void *ctx,
+                        HwCounters *hc, double hw[HW_COUNT], unsigned *got) {
+  if (setup)
+    setup(ctx);
+  if (hc)
+    hw_counters_start(hc);
+  double t0 = bench_now_ms();
+  run(ctx);
+  double dt = bench_now_ms() - t0;
+  if (hc)
+    *got = hw_counters_stop(hc, hw);
+  else
+    *got = 0;
+  return dt;
+}
+
+// Adds a counter reading to the sums of the kept samples; an event
+// missing from any of them is dropped
+static void add_reading(double sum[HW_COUNT], unsigned *mask,
+                        const double hw[HW_COUNT], unsigned got) {
+  *mask &= got;
+  for (int e = 0; e < HW_COUNT; e++)
+    if (got & (1u << e))
+      sum[e] += hw[e];
+}
+
+int bench_measure(const BenchOptions *opt, BenchFunc setup, BenchFunc run,
+                  void *ctx, BenchResult *out) {
+  int max_reps = opt->max_reps > 0 ? opt->max_reps : 1;
+  int min_reps = opt->min_reps > 0 ? opt->min_reps : 1;
+  double *samples = malloc(max_reps * sizeof(double));
+  if (!samples)
+    return -1;
+
+  // Counters are also read around the warmup runs: one longer than the
+  // budget is kept as the only sample, reading included
+  HwCounters hc;
+  int counting = opt->hw_counters && hw_counters_open(&hc) == 0;
+  double hw_sum[HW_COUNT] = {0};
+  unsigned hw_mask = counting ? ~0u : 0;
+
+  int n = 0, long_run = 0;
+  for (int w = 0; w < opt->warmup && !long_run && !is_cancelled(opt); w++) {
+    double hw[HW_COUNT];
+    unsigned got;
+    double dt = timed_run(setup, run, ctx, counting ? &hc : NULL, hw, &got);
+    // A single run longer than the whole budget: keep it as the only sample
+    // rather than repeating a multi-second sort
+    if (dt >= opt->budget_ms) {
+      samples[n++] = dt;
+      long_run = 1;
+      add_reading(hw_sum, &hw_mask, hw, got);
+    }
+  }
+
+  double total = 0;
+  while (!long_run && n < max_reps &&
+         (n < min_reps || total < opt->budget_ms) && !is_cancelled(opt)) {
+    double hw[HW_COUNT];
+    unsigned got;
+    double dt = timed_run(setup, run, ctx, counting ? &hc : NULL, hw, &got);
+    add_reading(hw_sum, &hw_mask, hw, got);
+    samples[n++] = dt;
+    total += dt;
+    long_run = dt >= opt->budget_ms;
+  }
+  if (counting)
+    hw_counters_close(&hc);
+
+  // Samples taken before a cancellation are still summarized
+  int cancelled = is_cancelled(opt);
+  summarize(samples, n, out);
+  free(samples);
+  if (n > 0)
+    out->hw_mask = hw_mask & ((1u << HW_COUNT) - 1);
+  for (int e = 0; e < HW_COUNT; e++)
+    out->hw[e] = out->hw_mask & (1u << e) ? hw_sum[e] / n : 0;
+  return cancelled ? -1 : 0;
+}
@@ -0,0 +1,233 @@
+#include "backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Streaming reader for the comma-separated text files of the sort and list
+// tabs. The file is read in blocks of CSV_CHUNK bytes into one buffer; the
+// field cut by the end of a block is moved to the front and completed by the
+// next read. The buffer only grows for a field longer than half of it, so
+// memory stays at one block whatever the file size, and every byte is
+// scanned once.
+
+// Fields are delimited 8 bytes at a time when there are at most
+// SWAR_SEPARATORS separators: a word is skipped whole when none of its bytes
+// matches, so the byte loop only runs on the word holding the field's end.
+#define SWAR_SEPARATORS 4
+#define ONES 0x0101010101010101ull
+#define HIGHS 0x8080808080808080ull
+
+typedef struct {
+  unsigned char is_sep[256];
+  int swar;
+  uint64_t splat[SWAR_SEPARATORS]; // Each separator in every byte
+} Separators;
+
+typedef struct {
+  DataType type;
+  size_t size; // Element size
+  StringArena *strings;
+  char *arr;
+  size_t n, cap;
+} ArrayLoad;
+
+static void separators_init(Separators *s, const char *chars) {
+  memset(s, 0, sizeof(*s));
+  size_t n = strlen(chars);
+  s->swar = n > 0 && n <= SWAR_SEPARATORS;
+  for (size_t i = 0; i < n; i++)
+    s->is_sep[(unsigned char)chars[i]] = 1;
+  // Unused slots repeat the first separator
+  for (size_t i = 0; s->swar && i < SWAR_SEPARATORS; i++)
+    s->splat[i] = ONES * (unsigned char)chars[i < n ? i : 0];
+}
+
+// Nonzero when a byte of w is zero
+static uint64_t has_zero(uint64_t w) { return (w - ONES) & ~w & HIGHS; }
+
+// First separator at or after q, or end
+static char *field_end(char *q, char *end, const Separators *s) {
+  if (s->swar)
+    for (uint64_t w; end - q >= 8; q += 8) {
+      memcpy(&w, q, 8);
+      if (has_zero(w ^ s->splat[0]) | has_zero(w ^ s->splat[1]) |
+          has_zero(w ^ s->splat[2]) | has_zero(w ^ s->splat[3]))
+        break;
+    }
+  while (q < end && !s->is_sep[(unsigned char)*q])
+    q++;
+  return q;
+}
+
+// Consumes the field starting at p (not a separator) and returns the byte
+// after it: a separator or end. Returns p when the field may continue past
+// end (not eof, nothing consumed), NULL on error.
+typedef char *(*FieldStep)(char *p, char *end, int eof, const Separators *s,
+                           void *ctx);
+
+static int read_blocks(FILE *f, const char *separators, FieldStep step,
+                       void *ctx, SortProgress progress, void *user) {
+  Separators sep;
+  separators_init(&sep, separators);
+
+  // Bytes left to read, for the progress fraction (unknown on a pipe)
+  long start = ftell(f), total = -1;
+  if (progress && start >= 0 && fseek(f, 0, SEEK_END) == 0) {
+    total = ftell(f) - start;
+    fseek(f, start, SEEK_SET);
+  }
+
+  size_t cap = CSV_CHUNK, carry = 0, done = 0;
+  char *buf = malloc(cap + 1); // + 1: room to terminate the last field
+  if (!buf)
+    return -1;
+  int rc = 0;
+  for (;;) {
+    if (carry > cap / 2) { // Long field: keep reads at least cap / 2
+      char *p = realloc(buf, cap * 2 + 1);
+      if (!p) {
+        rc = -1;
+        break;
+      }
+      buf = p;
+      cap *= 2;
+    }
+    size_t want = cap - carry;
+    size_t got = fread(buf + carry, 1, want, f);
+    if (ferror(f)) {
+      rc = -1;
+      break;
+    }
+    int eof = got < want;
+    char *p = buf, *end = buf + carry + got;
+    for (;;) {
+      while (p < end && sep.is_sep[(unsigned char)*p])
+        p++;
+      if (p == end)
+        break;
+      char *q = step(p, end, eof, &sep, ctx);
+      if (!q) {
+        rc = -1;
+        break;
+      }
+      if (q == p)
+        break; // Cut by the block end: completed by the next read
+      p = q;
+    }
+    if (rc != 0 || eof)
+      break;
+    carry = (size_t)(end - p);
+    memmove(buf, p, carry);
+    done += got;
+    if (progress && total > 0)
+      progress(done < (size_t)total ? (double)done / total : 1.0, user);
+  }
+  free(buf);
+  if (rc == 0 && progress)
+    progress(1.0, user);
+  return rc;
+}
+
+typedef struct {
+  CsvField field;
+  void *user;
+} FieldCall;
+
+static char *call_field(char *p, char *end, int eof, const Separators *s,
+                        void *ctx) {
+  FieldCall *c = ctx;
+  char *q = field_end(p, end, s);
+  if (q == end && !eof)
+    return p;
+  *q = 0; // The separator, or the spare byte after the data
+  return c->field(p, (size_t)(q - p), c->user) == 0 ? q + (q < end) : NULL;
+}
+
+int csv_read_fields(FILE *f, const char *separators, CsvField field,
+                    void *user, SortProgress progress, void *progress_user) {
+  FieldCall c = {field, user};
+  return read_blocks(f, separators, call_field, &c, progress, progress_user);
+}
+
+// Room for one more element
+static int reserve(ArrayLoad *a) {
+  if (a->n < a->cap)
+    return 0;
+  size_t cap = a->cap ? a->cap * 2 : 4096; // Amortized O(1) per element
+  char *arr = realloc(a->arr, cap * a->size);
+  if (!arr)
+    return -1;
+  a->arr = arr;
+  a->cap = cap;
+  return 0;
+}
+
+// Numbers are parsed straight from the block, the parser finding where they
+// end; only a field with trailing junk is scanned for its end (its value is
+// the number it starts with, 0 when there is none)
+static char *parse_number(char *p, char *end, int eof, const Separators *s,
+                          void *ctx) {
+  ArrayLoad *a = ctx;
+  int64_t iv = 0;
+  double dv = 0;
+  char *q = a->type == TYPE_INT ? (char *)parse_int64(p, end, &iv)
+                                : (char *)parse_double(p, end, &dv);
+  if (!q) {
+    iv = 0;
+    dv = 0;
+    q = field_end(p, end, s);
+  } else if (q < end && !s->is_sep[(unsigned char)*q]) {
+    q = field_end(q, end, s);
+  }
+  if (q == end && !eof)
+    return p;
+  if (reserve(a) != 0)
+    return NULL;
+  if (a->type == TYPE_INT)
+    ((int *)a->arr)[a->n++] = (int)iv;
+  else
+    ((double *)a->arr)[a->n++] = dv;
+  return q + (q < end);
+}
+
+static int append_field(char *p, size_t len, void *user) {
+  ArrayLoad *a = user;
+  if (reserve(a) != 0)
+    return -1;
+  if (a->type == TYPE_CHAR) {
+    a->arr[a->n++] = p[0];
+    return 0;
+  }
+  char *s = string_arena_alloc(a->strings, len + 1);
+  if (!s)
+    return -1;
+  memcpy(s, p, len + 1);
+  ((char **)a->arr)[a->n++] = s;
+  return 0;
+}
+
+int csv_read_array(FILE *f, const char *separators, DataType t,
+                   StringArena *strings, SortProgress progress, void *user,
+                   void **out, size_t *count) {
+  ArrayLoad a = {t, get_element_size(t), strings, NULL, 0, 0};
+  *out = NULL;
+  *count = 0;
+  int rc = -1;
+  if (t == TYPE_INT || t == TYPE_DOUBLE)
+    rc = read_blocks(f, separators, parse_number, &a, progress, user);
+  else if (t == TYPE_CHAR || t == TYPE_STRING)
+    rc = csv_read_fields(f, separators, append_field, &a, progress, user);
+  if (rc != 0) {
+    free(a.arr);
+    return -1;
+  }
+  // Give back the unused tail of the last doubling
+  if (a.n > 0 && a.n < a.cap) {
+    char *arr = realloc(a.arr, a.n * a.size);
+    if (arr)
+      a.arr = arr;
+  }
+  *out = a.arr;
+  *count = a.n;
+  return 0;
+}
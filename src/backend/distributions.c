@@ -0,0 +1,327 @@
+#include "backend.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Input generators for the sort tab and sorter_bench. Every distribution
+// first produces integer keys in [0, range), then maps them to the DataType
+// with an order-preserving function, so "sorted", "organ pipe", runs, ... keep
+// their shape for every type:
+//  - int: the key itself
+//  - double: key scaled to [0, 1000)
+//  - char: key scaled to 'A'..'Z'
+//  - string: key scaled to [0, 26^8), written as 8 base-26 letters
+// Random numbers are counter based: the draw for element i is splitmix64 of
+// (seed, i), with no state carried from one element to the next. Slices
+// of the array are filled by sort_parallel_threads() threads, and the data
+// depends only on the seed, never on the thread count.
+
+#define STR_LEN 8
+#define STR_RANGE 208827064576.0 // 26^8
+#define ZIPF_MAX_VALUES 65536    // Size of the Zipf CDF table
+#define GEN_GRAIN 65536          // Minimum elements per thread
+
+static const char *NAMES[DIST_COUNT] = {
+    [DIST_RANDOM] = "random",
+    [DIST_SORTED] = "sorted",
+    [DIST_REVERSED] = "reversed",
+    [DIST_FEW_UNIQUE] = "few_unique",
+    [DIST_ORGAN_PIPE] = "organ_pipe",
+    [DIST_SAWTOOTH] = "sawtooth",
+    [DIST_NEARLY_SORTED] = "nearly_sorted",
+    [DIST_ZIPF] = "zipf",
+    [DIST_ALL_EQUAL] = "all_equal",
+    [DIST_SORTED_RUNS] = "sorted_runs",
+};
+
+const char *dist_name(Distribution d) {
+  return (unsigned)d < DIST_COUNT ? NAMES[d] : "?";
+}
+
+int dist_from_name(const char *name) {
+  for (int d = 0; d < DIST_COUNT; d++)
+    if (!strcmp(name, NAMES[d]))
+      return d;
+  return -1;
+}
+
+void dist_default_params(DistParams *p) {
+  p->range = 0;
+  p->unique = 16;
+  p->swaps = 10;
+  p->run_length = 64;
+  p->zipf_s = 1.0;
+}
+
+// --- Random numbers ---
+
+static uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// Draw i of a stream (0: elements, 1: swaps); independent of call order
+static uint64_t random_at(uint64_t key, uint64_t stream, uint64_t i) {
+  return mix64(key + (2 * i + stream + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+// Uniform in [0, 1)
+static double unit(uint64_t r) {
+  return (r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// --- Keys ---
+
+// Shared, read-only description of one generation
+typedef struct {
+  void *arr;
+  size_t n;
+  DataType type;
+  Distribution dist;
+  const DistParams *params;
+  double range;
+  uint64_t key;       // Mixed seed
+  const double *cdf;  // Zipf only
+  size_t zipf_values; // Zipf only
+  char *strings;      // TYPE_STRING: n slots of STR_LEN + 1 bytes
+} GenJob;
+
+typedef struct {
+  const GenJob *job;
+  size_t lo, hi; // Element slice
+  int failed;
+} GenTask;
+
+static int cmp_key(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double zipf_key(const GenJob *job, uint64_t r) {
+  double u = unit(r) * job->cdf[job->zipf_values - 1];
+  size_t lo = 0, hi = job->zipf_values - 1; // First rank with cdf > u
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (job->cdf[mid] > u)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return floor((double)lo * job->range / job->zipf_values);
+}
+
+// Key of element i (before the sorted-runs and nearly-sorted passes)
+static double key_at(const GenJob *job, size_t i) {
+  const DistParams *p = job->params;
+  double range = job->range, n = (double)job->n;
+  uint64_t r = random_at(job->key, 0, i);
+  switch (job->dist) {
+  case DIST_SORTED:
+  case DIST_NEARLY_SORTED:
+    return floor((double)i * range / n);
+  case DIST_REVERSED:
+    return floor((double)(job->n - 1 - i) * range / n);
+  case DIST_FEW_UNIQUE: {
+    // `unique` values spread over the whole range
+    double unique = (double)(p->unique > 0 ? p->unique : 1);
+    return floor(floor(unit(r) * unique) * range / unique);
+  }
+  case DIST_ORGAN_PIPE: {
+    // Ascending to the middle, then descending back
+    size_t half = (job->n + 1) / 2;
+    size_t pos = i < half ? i : job->n - 1 - i;
+    return floor((double)pos * range / half);
+  }
+  case DIST_SAWTOOTH: {
+    size_t run = p->run_length > 0 ? p->run_length : 1;
+    return floor((double)(i % run) * range / run);
+  }
+  case DIST_ZIPF:
+    return zipf_key(job, r);
+  case DIST_ALL_EQUAL:
+    return floor(range / 2);
+  default: // Random, sorted runs
+    return floor(unit(r) * range);
+  }
+}
+
+// --- Mapping to the DataType ---
+
+static double default_range(DataType t) {
+  switch (t) {
+  case TYPE_INT:
+    return 2147483647.0; // INT_MAX
+  case TYPE_CHAR:
+    return 26;
+  case TYPE_STRING:
+    return STR_RANGE;
+  default:
+    return 9007199254740992.0; // 2^53, double keys stay exact
+  }
+}
+
+static void store_key(const GenJob *job, size_t i, double key) {
+  switch (job->type) {
+  case TYPE_INT:
+    ((int *)job->arr)[i] = (int)key;
+    break;
+  case TYPE_DOUBLE:
+    ((double *)job->arr)[i] = key * (1000.0 / job->range);
+    break;
+  case TYPE_CHAR:
+    ((char *)job->arr)[i] = (char)('A' + (int)floor(key * 26 / job->range));
+    break;
+  default: {
+    char *s = job->strings + i * (STR_LEN + 1);
+    double v = floor(key * (STR_RANGE / job->range));
+    for (int j = STR_LEN - 1; j >= 0; j--) {
+      double q = floor(v / 26);
+      s[j] = (char)('a' + (int)(v - q * 26));
+      v = q;
+    }
+    s[STR_LEN] = 0;
+    ((char **)job->arr)[i] = s;
+  } break;
+  }
+}
+
+static void *gen_thread(void *arg) {
+  GenTask *t = arg;
+  const GenJob *job = t->job;
+  if (t->lo >= t->hi)
+    return NULL;
+  if (job->dist != DIST_SORTED_RUNS) {
+    for (size_t i = t->lo; i < t->hi; i++)
+      store_key(job, i, key_at(job, i));
+    return NULL;
+  }
+  // Slices start on a run boundary: each run is drawn and sorted here
+  size_t run = job->params->run_length > 0 ? job->params->run_length : 1;
+  size_t len = run < t->hi - t->lo ? run : t->hi - t->lo;
+  double *keys = malloc(len * sizeof(double));
+  if (!keys) {
+    t->failed = 1;
+    return NULL;
+  }
+  for (size_t lo = t->lo; lo < t->hi; lo += run) {
+    size_t m = t->hi - lo < run ? t->hi - lo : run;
+    for (size_t i = 0; i < m; i++)
+      keys[i] = key_at(job, lo + i);
+    qsort(keys, m, sizeof(double), cmp_key);
+    for (size_t i = 0; i < m; i++)
+      store_key(job, lo + i, keys[i]);
+  }
+  free(keys);
+  return NULL;
+}
+
+// Splits [0, n) into slices (multiples of `align`) over the threads
+static int run_slices(const GenJob *job, size_t align) {
+  size_t n = job->n;
+  int count = sort_parallel_threads();
+  if ((size_t)count > n / GEN_GRAIN)
+    count = n / GEN_GRAIN > 0 ? (int)(n / GEN_GRAIN) : 1;
+  GenTask *tasks = calloc(count, sizeof(GenTask));
+  pthread_t *tids = malloc(count * sizeof(pthread_t));
+  int *spawned = calloc(count, sizeof(int));
+  if (!tasks || !tids || !spawned) {
+    free(tasks);
+    free(tids);
+    free(spawned);
+    return -1;
+  }
+  size_t units = (n + align - 1) / align;
+  for (int k = 0; k < count; k++) {
+    tasks[k].job = job;
+    tasks[k].lo = units * k / count * align;
+    tasks[k].hi = units * (k + 1) / count * align;
+    if (tasks[k].hi > n)
+      tasks[k].hi = n;
+  }
+  // Slice 0 on the calling thread; a slice whose thread cannot start too
+  for (int k = 1; k < count; k++) {
+    spawned[k] = pthread_create(&tids[k], NULL, gen_thread, &tasks[k]) == 0;
+    if (!spawned[k])
+      gen_thread(&tasks[k]);
+  }
+  gen_thread(&tasks[0]);
+  int failed = 0;
+  for (int k = 0; k < count; k++) {
+    if (spawned[k])
+      pthread_join(tids[k], NULL);
+    failed |= tasks[k].failed;
+  }
+  free(tasks);
+  free(tids);
+  free(spawned);
+  return failed ? -1 : 0;
+}
+
+// Nearly sorted: `swaps` exchanges after the parallel fill, drawn from a
+// second stream so they do not depend on the slicing either
+static void apply_swaps(const GenJob *job) {
+  size_t es = get_element_size(job->type);
+  char tmp[sizeof(double)];
+  char *base = job->arr;
+  for (size_t k = 0; k < job->params->swaps && job->n > 1; k++) {
+    size_t a = (size_t)(unit(random_at(job->key, 1, 2 * k)) * job->n);
+    size_t b = (size_t)(unit(random_at(job->key, 1, 2 * k + 1)) * job->n);
+    memcpy(tmp, base + a * es, es);
+    memcpy(base + a * es, base + b * es, es);
+    memcpy(base + b * es, tmp, es);
+  }
+}
+
+int generate_distribution(void *arr, size_t n, DataType t, Distribution d,
+                          const DistParams *params, unsigned seed,
+                          StringArena *strings) {
+  if (t >= TYPE_CUSTOM || (unsigned)d >= DIST_COUNT ||
+      (t == TYPE_STRING && !strings))
+    return -1;
+  if (n == 0)
+    return 0;
+  DistParams defaults;
+  if (!params) {
+    dist_default_params(&defaults);
+    params = &defaults;
+  }
+  GenJob job = {arr, n, t, d, params, default_range(t), mix64(seed),
+                NULL, 0, NULL};
+  if (params->range > 0 && (double)params->range < job.range)
+    job.range = (double)params->range;
+
+  // Every string of the array in one arena allocation
+  if (t == TYPE_STRING) {
+    job.strings = string_arena_alloc(strings, n * (STR_LEN + 1));
+    if (!job.strings)
+      return -1;
+  }
+
+  // Zipf(s) over `unique` ranks through a cumulative table; rank 0 is the
+  // most frequent and maps to the smallest key
+  double *cdf = NULL;
+  if (d == DIST_ZIPF) {
+    job.zipf_values = params->unique > 0 ? params->unique : 1;
+    if (job.zipf_values > ZIPF_MAX_VALUES)
+      job.zipf_values = ZIPF_MAX_VALUES;
+    cdf = malloc(job.zipf_values * sizeof(double));
+    if (!cdf)
+      return -1;
+    double sum = 0;
+    for (size_t r = 0; r < job.zipf_values; r++)
+      cdf[r] = sum += pow((double)(r + 1), -params->zipf_s);
+    job.cdf = cdf;
+  }
+
+  size_t align = 1;
+  if (d == DIST_SORTED_RUNS && params->run_length > 0)
+    align = params->run_length;
+  int rc = run_slices(&job, align);
+  if (rc == 0 && d == DIST_NEARLY_SORTED)
+    apply_swaps(&job);
+  free(cdf);
+  return rc;
+}
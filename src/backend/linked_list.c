@@ -55,6 +55,24 @@ void list_init(LinkedList *list, DataType type, int is_doubly) {
   list->is_doubly = is_doubly;
 }
 
+void list_init_pooled(LinkedList *list, DataType type, int is_doubly,
+                      Node *nodes, const void *values, size_t n) {
+  list_init(list, type, is_doubly);
+  if (n == 0)
+    return;
+  size_t size = get_element_size(type);
+  for (size_t i = 0; i < n; i++) {
+    // A string node holds the string itself, not a char ** slot
+    nodes[i].data = type == TYPE_STRING ? ((char *const *)values)[i]
+                                        : (char *)values + i * size;
+    nodes[i].next = i + 1 < n ? &nodes[i + 1] : NULL;
+    nodes[i].prev = is_doubly && i > 0 ? &nodes[i - 1] : NULL;
+  }
+  list->head = &nodes[0];
+  list->tail = &nodes[n - 1];
+  list->size = n;
+}
+
 static Node *create_node(void *value, DataType type) {
   Node *new_node = (Node *)malloc(sizeof(Node));
   if (!new_node)
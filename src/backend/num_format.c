@@ -0,0 +1,302 @@
+#include "backend.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number to text and back without the printf/strtod machinery on the common
+// cases: integers two digits at a time from a table of the 100 pairs,
+// doubles as integers scaled by a power of ten, and parsing that takes
+// digits 8 at a time. Inputs outside the fast paths fall back to the C
+// library, so results always match it.
+
+static const char PAIRS[201] = "00010203040506070809"
+                               "10111213141516171819"
+                               "20212223242526272829"
+                               "30313233343536373839"
+                               "40414243444546474849"
+                               "50515253545556575859"
+                               "60616263646566676869"
+                               "70717273747576777879"
+                               "80818283848586878889"
+                               "90919293949596979899";
+
+// Digits of u, written backwards ending at end; returns the first digit
+static char *write_u64(char *end, uint64_t u) {
+  while (u >= 100) {
+    unsigned pair = (unsigned)(u % 100) * 2;
+    u /= 100;
+    end -= 2;
+    memcpy(end, PAIRS + pair, 2);
+  }
+  if (u >= 10) {
+    end -= 2;
+    memcpy(end, PAIRS + u * 2, 2);
+  } else {
+    *--end = (char)('0' + u);
+  }
+  return end;
+}
+
+size_t fmt_int64(char *buf, int64_t v) {
+  char tmp[20];
+  // Negated as unsigned, so INT64_MIN works too
+  uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+  char *p = write_u64(tmp + sizeof(tmp), u);
+  size_t len = (size_t)(tmp + sizeof(tmp) - p);
+  char *out = buf;
+  if (v < 0)
+    *out++ = '-';
+  memcpy(out, p, len);
+  out[len] = 0;
+  return (size_t)(out - buf) + len;
+}
+
+// The fast path rounds v * 10^decimals to an integer the way printf rounds
+// the exact binary value: the product x is rounded, but fma gives the
+// exact remainder e (v * 10^decimals = x + e). Below 2^52 a half is a
+// double, so x + e can only fall on the other side of a half when x is
+// that half; e then decides, and a true tie goes to even (nearbyint,
+// current rounding mode, as printf).
+size_t fmt_fixed(char *buf, double v, int decimals) {
+  static const double SCALE[10] = {1e0, 1e1, 1e2, 1e3, 1e4,
+                                   1e5, 1e6, 1e7, 1e8, 1e9};
+  double a = fabs(v);
+  double x = decimals >= 0 && decimals <= 9 ? a * SCALE[decimals] : NAN;
+  // Large, non-finite or odd requests take the slow path
+  if (!(x < 4503599627370496.0)) { // 2^52
+    int len = snprintf(buf, 32, "%.*f", decimals, v);
+    return len < 0 ? 0 : len < 32 ? (size_t)len : 31;
+  }
+  double e = fma(a, SCALE[decimals], -x);
+  double r = nearbyint(x);
+  if (e != 0 && x - floor(x) == 0.5)
+    r = e > 0 ? ceil(x) : floor(x);
+  uint64_t scale = (uint64_t)SCALE[decimals];
+  uint64_t u = (uint64_t)r;
+  char tmp[32];
+  char *end = tmp + sizeof(tmp), *p = end;
+  if (decimals > 0) {
+    uint64_t frac = u % scale;
+    for (int d = 0; d < decimals; d++) {
+      *--p = (char)('0' + frac % 10);
+      frac /= 10;
+    }
+    *--p = '.';
+  }
+  p = write_u64(p, u / scale);
+  if (signbit(v))
+    *--p = '-';
+  size_t len = (size_t)(end - p);
+  memcpy(buf, p, len);
+  buf[len] = 0;
+  return len;
+}
+
+// Decimal that reads back as v, with the fewest significant digits. Values
+// that are a short decimal fraction (m / 10^d, m below 2^53) get it from a
+// few multiplications; the others, full-precision values mostly, are
+// written with %.15g, %.16g then %.17g, keeping the first that reads back.
+// A decimal of at most 15 digits that reads back as v is what %.15g
+// prints (for normal values), so when that does not read back no shorter
+// one does; %.17g always does.
+size_t fmt_double(char *buf, double v) {
+  static const double POW10[16] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15};
+  double a = fabs(v);
+  if (a < 9007199254740992.0 && a >= 1e-9) {
+    for (int d = 0; d < 16; d++) {
+      double m = round(a * POW10[d]);
+      if (m >= 9007199254740992.0)
+        break;
+      // m / 10^d is correctly rounded, so equality means the decimal
+      // m * 10^-d reads back as a; the first d is the shortest
+      if (m / POW10[d] == a) {
+        char *p = buf;
+        if (signbit(v))
+          *p++ = '-';
+        size_t len = fmt_int64(p, (int64_t)m);
+        if (d > 0) {
+          // Insert the point, padding with zeros below 1
+          size_t digits = len > (size_t)d ? len : (size_t)d + 1;
+          memmove(p + digits - len, p, len);
+          memset(p, '0', digits - len);
+          memmove(p + digits - d + 1, p + digits - d, d);
+          p[digits - d] = '.';
+          len = digits + 1;
+        }
+        p[len] = 0;
+        return (size_t)(p - buf) + len;
+      }
+    }
+  }
+  if (v == 0) {
+    strcpy(buf, signbit(v) ? "-0" : "0");
+    return strlen(buf);
+  }
+  // Subnormals hold fewer digits: their search starts from one
+  int prec = a < DBL_MIN ? 1 : 15;
+  int len = snprintf(buf, 32, "%.*g", prec, v);
+  while (prec < 17 && strtod(buf, NULL) != v)
+    len = snprintf(buf, 32, "%.*g", ++prec, v);
+  return (size_t)len;
+}
+
+// --- Parsing ---
+// Digits are taken 8 at a time when the bytes are there: one 64-bit load,
+// a check that all 8 are digits, and three multiplications to combine
+// them (SWAR). The byte order trick needs a little-endian target.
+
+#if (defined(__BYTE_ORDER__) &&                                               \
+     __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ||                             \
+    defined(_WIN32) || defined(__x86_64__) || defined(__i386__)
+#define SWAR_DIGITS 1
+#else
+#define SWAR_DIGITS 0
+#endif
+
+static int all_digits8(uint64_t v) {
+  return ((v & 0xF0F0F0F0F0F0F0F0ull) |
+          (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+         0x3333333333333333ull;
+}
+
+// Value of 8 ASCII digits, first digit in the low byte
+static uint32_t digits8(uint64_t v) {
+  v -= 0x3030303030303030ull;
+  v = v * 10 + (v >> 8); // Pairs
+  v = ((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32)) +
+       ((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >>
+      32;
+  return (uint32_t)v;
+}
+
+// Accumulates the digits at p into *m; *count gets their number, including
+// the ones beyond 19 that no longer fit (then *m is left unusable)
+static const char *scan_digits(const char *p, const char *end, uint64_t *m,
+                               int *count) {
+  uint64_t acc = *m;
+  int n = 0;
+#if SWAR_DIGITS
+  while (end - p >= 8) {
+    uint64_t chunk;
+    memcpy(&chunk, p, 8);
+    if (!all_digits8(chunk))
+      break;
+    if (*count + n + 8 <= 19)
+      acc = acc * 100000000u + digits8(chunk);
+    n += 8;
+    p += 8;
+  }
+#endif
+  for (; p < end && *p >= '0' && *p <= '9'; p++, n++)
+    if (*count + n < 19)
+      acc = acc * 10 + (uint64_t)(*p - '0');
+  *m = acc;
+  *count += n;
+  return p;
+}
+
+static const char *skip_blanks(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  return p;
+}
+
+const char *parse_int64(const char *p, const char *end, int64_t *out) {
+  p = skip_blanks(p, end);
+  int neg = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+'))
+    p++;
+  const char *start = p;
+  while (p < end && *p == '0') // Leading zeros do not count against 19
+    p++;
+  uint64_t m = 0;
+  int count = 0;
+  p = scan_digits(p, end, &m, &count);
+  if (p == start)
+    return NULL;
+  // 19 digits fit in uint64_t; clamp like strtoll beyond int64_t
+  uint64_t limit = neg ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+  if (count > 19 || m > limit)
+    m = limit;
+  *out = neg ? (int64_t)(0 - m) : (int64_t)m;
+  return p;
+}
+
+const char *parse_double(const char *p, const char *end, double *out) {
+  static const double POW10[23] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  p = skip_blanks(p, end);
+  const char *start = p;
+  int neg = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+'))
+    p++;
+  const char *digits = p;
+  while (p < end && *p == '0')
+    p++;
+  uint64_t m = 0;
+  int count = 0;
+  p = scan_digits(p, end, &m, &count);
+  int exp10 = 0, any = p > digits;
+  if (p < end && *p == '.') {
+    const char *frac = ++p;
+    if (count == 0) // 0.000123: zeros after the point shift the exponent
+      while (p < end && *p == '0')
+        p++;
+    exp10 -= (int)(p - frac);
+    const char *fdigits = p;
+    p = scan_digits(p, end, &m, &count);
+    exp10 -= (int)(p - fdigits);
+    any = any || p > frac;
+  }
+  if (!any) // inf, nan, hex floats...: strtod decides
+    goto slow;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    int eneg = q < end && *q == '-';
+    if (q < end && (*q == '-' || *q == '+'))
+      q++;
+    if (q < end && *q >= '0' && *q <= '9') {
+      int e = 0;
+      for (; q < end && *q >= '0' && *q <= '9'; q++)
+        if (e < 100000)
+          e = e * 10 + (*q - '0');
+      exp10 += eneg ? -e : e;
+      p = q;
+    }
+  }
+  // Exact when the mantissa and the power of ten are both exact doubles:
+  // one correctly rounded operation (Clinger's fast path)
+  if (count <= 19 && m <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+    double d = (double)m;
+    d = exp10 < 0 ? d / POW10[-exp10] : d * POW10[exp10];
+    *out = neg ? -d : d;
+    return p;
+  }
+
+slow:;
+  // strtod needs a terminated copy of the number
+  char small[64];
+  const char *q = p > start ? p : start;
+  while (q < end && q - start < 400 && *q != ',' && *q != '\n' &&
+         *q != '\r' && *q != ' ')
+    q++;
+  size_t len = (size_t)(q - start);
+  char *copy = len < sizeof(small) ? small : malloc(len + 1);
+  if (!copy)
+    return NULL;
+  memcpy(copy, start, len);
+  copy[len] = 0;
+  char *stop;
+  double d = strtod(copy, &stop);
+  const char *res = stop > copy ? start + (stop - copy) : NULL;
+  if (res)
+    *out = d;
+  if (copy != small)
+    free(copy);
+  return res;
+}
@@ -0,0 +1,119 @@
+#include "backend.h"
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters around a timed region, through perf_event_open on Linux.
+// Each event is opened on its own rather than as a group, so a PMU missing
+// one event still reports the others, and with inherit set so the threads
+// spawned by the parallel sorts are counted too. Counts are scaled by
+// time_enabled / time_running when the kernel multiplexes the PMU.
+// Elsewhere (other systems, containers and VMs without a PMU,
+// perf_event_paranoid too high) hw_counters_open fails and callers keep
+// timings only.
+
+static const char *NAMES[HW_COUNT] = {
+    [HW_CYCLES] = "cycles",
+    [HW_INSTRUCTIONS] = "instructions",
+    [HW_L1D_MISSES] = "l1d_misses",
+    [HW_LLC_MISSES] = "llc_misses",
+    [HW_BRANCH_MISSES] = "branch_misses",
+};
+
+const char *hw_counter_name(HwCounter c) {
+  return (unsigned)c < HW_COUNT ? NAMES[c] : "?";
+}
+
+#ifdef __linux__
+
+static const struct {
+  uint32_t type;
+  uint64_t config;
+} EVENTS[HW_COUNT] = {
+    [HW_CYCLES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [HW_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [HW_L1D_MISSES] = {PERF_TYPE_HW_CACHE,
+                       PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    [HW_LLC_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    [HW_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int hw_counters_open(HwCounters *hc) {
+  int opened = 0;
+  for (int e = 0; e < HW_COUNT; e++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = EVENTS[e].type;
+    attr.config = EVENTS[e].config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1; // Allowed with perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    hc->fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    opened += hc->fd[e] >= 0;
+  }
+  return opened ? 0 : -1;
+}
+
+void hw_counters_start(HwCounters *hc) {
+  for (int e = 0; e < HW_COUNT; e++)
+    if (hc->fd[e] >= 0) {
+      ioctl(hc->fd[e], PERF_EVENT_IOC_RESET, 0);
+      ioctl(hc->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+unsigned hw_counters_stop(HwCounters *hc, double out[HW_COUNT]) {
+  unsigned mask = 0;
+  for (int e = 0; e < HW_COUNT; e++)
+    if (hc->fd[e] >= 0)
+      ioctl(hc->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+  for (int e = 0; e < HW_COUNT; e++) {
+    out[e] = 0;
+    uint64_t v[3]; // value, time enabled, time running
+    if (hc->fd[e] < 0 || read(hc->fd[e], v, sizeof(v)) != sizeof(v))
+      continue;
+    if (v[2] == 0)
+      continue; // Never scheduled on the PMU
+    out[e] = v[2] < v[1] ? (double)v[0] * v[1] / v[2] : (double)v[0];
+    mask |= 1u << e;
+  }
+  return mask;
+}
+
+void hw_counters_close(HwCounters *hc) {
+  for (int e = 0; e < HW_COUNT; e++) {
+    if (hc->fd[e] >= 0)
+      close(hc->fd[e]);
+    hc->fd[e] = -1;
+  }
+}
+
+#else
+
+int hw_counters_open(HwCounters *hc) {
+  for (int e = 0; e < HW_COUNT; e++)
+    hc->fd[e] = -1;
+  return -1;
+}
+
+void hw_counters_start(HwCounters *hc) {}
+
+unsigned hw_counters_stop(HwCounters *hc, double out[HW_COUNT]) {
+  memset(out, 0, HW_COUNT * sizeof(double));
+  return 0;
+}
+
+void hw_counters_close(HwCounters *hc) {}
+
+#endif
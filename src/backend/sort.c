@@ -1,6 +1,9 @@
 #include "backend.h"
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 // Helper for swapping
@@ -73,55 +76,168 @@ void sort_shell(int *arr, size_t n, SortStats *stats) {
   }
 }
 
-// --- 4. Quick Sort ---
-static size_t partition(int *arr, int low, int high, SortStats *stats) {
-  int pivot = arr[high];
-  int i = (low - 1);
+// --- 4. Quick Sort (Introsort) ---
+// Median-of-three / ninther pivot, Hoare partition (balanced on duplicates),
+// loop on the larger side so the stack stays O(log n), insertion sort for
+// small partitions and heapsort once the depth budget (2*log2(n)) is spent.
+// With AVX2, partitions up to SORT_NETWORK_MAX go to the sorting network.
+#define INTRO_CUTOFF 16
 
-  for (int j = low; j <= high - 1; j++) {
-    stats->comparisons++;
-    if (arr[j] <
-        pivot) { // Changed condition to match standard quicksort (ascending)
-      i++;
-      stats->assignments++;
-      swap(&arr[i], &arr[j]);
+static void insertion_range(int *arr, size_t lo, size_t hi, SortStats *stats) {
+  for (size_t i = lo + 1; i < hi; i++) {
+    int key = arr[i];
+    size_t j = i;
+    while (j > lo) {
+      stats->comparisons++;
+      if (arr[j - 1] > key) {
+        stats->assignments++;
+        arr[j] = arr[j - 1];
+        j--;
+      } else {
+        break;
+      }
     }
+    arr[j] = key;
   }
-  stats->assignments++;
-  swap(&arr[i + 1], &arr[high]);
-  return (i + 1);
 }
 
-static void quick_recursive(int *arr, int low, int high, SortStats *stats) {
-  if (low < high) {
-    size_t pi = partition(arr, low, high, stats);
-    // Be careful with unsigned size_t valid range vs int indices
-    // Since we pass int low/high, we cast pi back to int
-    quick_recursive(arr, low, (int)pi - 1, stats);
-    quick_recursive(arr, (int)pi + 1, high, stats);
+static void sift_down(int *arr, size_t root, size_t n, SortStats *stats) {
+  for (;;) {
+    size_t child = 2 * root + 1;
+    if (child >= n)
+      return;
+    if (child + 1 < n) {
+      stats->comparisons++;
+      if (arr[child] < arr[child + 1])
+        child++;
+    }
+    stats->comparisons++;
+    if (arr[root] >= arr[child])
+      return;
+    stats->assignments++;
+    swap(&arr[root], &arr[child]);
+    root = child;
   }
 }
 
-void sort_quick(int *arr, size_t n, SortStats *stats) {
-  stats->comparisons = 0;
-  stats->assignments = 0;
-  if (n > 0) {
-    quick_recursive(arr, 0, (int)n - 1, stats);
+static void heap_range(int *arr, size_t n, SortStats *stats) {
+  for (size_t i = n / 2; i > 0; i--)
+    sift_down(arr, i - 1, n, stats);
+  for (size_t end = n - 1; end > 0; end--) {
+    stats->assignments++;
+    swap(&arr[0], &arr[end]);
+    sift_down(arr, 0, end, stats);
   }
 }
 
-void generate_array(int *arr, size_t n, int type) {
-  if (type == 0) { // Random
-    for (size_t i = 0; i < n; i++) {
-      arr[i] = rand() % 100; // 0-99
-    }
-  } else if (type == 1) { // Sorted
-    for (size_t i = 0; i < n; i++) {
-      arr[i] = (int)i;
+static size_t median3(int *arr, size_t a, size_t b, size_t c,
+                      SortStats *stats) {
+  stats->comparisons += 2;
+  if (arr[a] < arr[b]) {
+    if (arr[b] < arr[c])
+      return b;
+    stats->comparisons++;
+    return arr[a] < arr[c] ? c : a;
+  }
+  if (arr[a] < arr[c])
+    return a;
+  stats->comparisons++;
+  return arr[b] < arr[c] ? c : b;
+}
+
+static size_t choose_pivot(int *arr, size_t lo, size_t hi, SortStats *stats) {
+  size_t n = hi - lo;
+  size_t mid = lo + n / 2;
+  if (n < 128)
+    return median3(arr, lo, mid, hi - 1, stats);
+  // Tukey's ninther for large partitions
+  size_t s = n / 8;
+  size_t a = median3(arr, lo, lo + s, lo + 2 * s, stats);
+  size_t b = median3(arr, mid - s, mid, mid + s, stats);
+  size_t c = median3(arr, hi - 1 - 2 * s, hi - 1 - s, hi - 1, stats);
+  return median3(arr, a, b, c, stats);
+}
+
+// Partitions [lo, hi) around the chosen pivot and returns its final index
+static size_t partition(int *arr, size_t lo, size_t hi, SortStats *stats) {
+  size_t p = choose_pivot(arr, lo, hi, stats);
+  stats->assignments++;
+  swap(&arr[lo], &arr[p]);
+  int pivot = arr[lo];
+
+  size_t i = lo, j = hi;
+  for (;;) {
+    do {
+      i++;
+      stats->comparisons++;
+    } while (i < hi - 1 && arr[i] < pivot);
+    do {
+      j--;
+      stats->comparisons++;
+    } while (arr[j] > pivot);
+    if (i >= j)
+      break;
+    stats->assignments++;
+    swap(&arr[i], &arr[j]);
+  }
+  stats->assignments++;
+  swap(&arr[lo], &arr[j]);
+  return j;
+}
+
+static void introsort_loop(int *arr, size_t lo, size_t hi, int depth,
+                           SortStats *stats) {
+  size_t cutoff = sort_network_available() ? SORT_NETWORK_MAX : INTRO_CUTOFF;
+  while (hi - lo > cutoff) {
+    if (depth == 0) {
+      heap_range(arr + lo, hi - lo, stats);
+      return;
     }
-  } else if (type == 2) { // Reversed
-    for (size_t i = 0; i < n; i++) {
-      arr[i] = (int)(n - 1 - i);
+    depth--;
+    size_t p = partition(arr, lo, hi, stats);
+    // Recurse on the smaller side, iterate on the larger one
+    if (p - lo < hi - p - 1) {
+      introsort_loop(arr, lo, p, depth, stats);
+      lo = p + 1;
+    } else {
+      introsort_loop(arr, p + 1, hi, depth, stats);
+      hi = p;
     }
   }
-}
\ No newline at end of file
+  if (cutoff > INTRO_CUTOFF)
+    sort_network_int(arr + lo, hi - lo, stats);
+  else
+    insertion_range(arr, lo, hi, stats);
+}
+
+void sort_quick(int *arr, size_t n, SortStats *stats) {
+  // Small key domains are histogrammed instead; on fallback the stats keep
+  // the cost of the min/max pre-scan.
+  if (sort_counting_int(arr, n, stats))
+    return;
+  if (n < 2)
+    return;
+  int depth = 0;
+  for (size_t m = n; m > 1; m >>= 1)
+    depth += 2;
+  introsort_loop(arr, 0, n, depth, stats);
+}
+
+// --- 5. Radix Sort / 6. Counting Sort ---
+// Both live in sort_radix_template.h, instantiated with operation counting
+// and, suffix _clean, without it for get_sort_kernel_clean.
+#define COUNTING_MAX_RANGE 65536
+
+#include "sort_radix_template.h"
+
+#define SORT_NO_STATS
+#include "sort_radix_template.h"
+
+// Legacy int-only entry point, kept on top of generate_distribution
+void generate_array(int *arr, size_t n, int type) {
+  DistParams params;
+  dist_default_params(&params);
+  params.range = 100;
+  generate_distribution(arr, n, TYPE_INT, (Distribution)type, &params,
+                        (unsigned)rand(), NULL);
+}
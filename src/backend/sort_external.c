@@ -0,0 +1,496 @@
+#include "backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// External merge sort for files that do not fit in memory.
+// Phase 1 reads the input in chunks of at most mem_limit bytes, sorts each
+// chunk with the in-place typed kernel and appends it as a binary run to a
+// spill tmpfile() (raw elements, or NUL-terminated bytes for strings).
+// Phase 2 merges up to EXT_FANIN runs at a time through a min-heap, in as
+// many passes as needed, each pass into a fresh spill file; the last pass
+// writes the sort tab's text format: the DataType on the first line, then
+// comma-separated values.
+// A run is a segment of its spill file, read through a buffer of its own,
+// so however many runs there are, at most two spill files are open and a
+// merge holds EXT_FANIN run buffers plus the two spill files' stdio buffers,
+// each mem_limit / (EXT_FANIN + 2) bytes.
+
+#define EXT_FANIN 64
+#define EXT_MIN_MEMORY (64 * 1024)
+#define EXT_PROGRESS_STEP 65536
+
+typedef struct {
+  DataType type;
+  SortStats *stats;
+  SortProgress progress;
+  void *user;
+  size_t bufsize;     // Bytes of each run buffer and spill stdio buffer
+  size_t total;       // Elements read in phase 1
+  size_t merge_done;  // Elements written by merge passes so far
+  size_t merge_total; // total * number of passes
+} ExtContext;
+
+typedef struct {
+  fpos_t pos; // Start in the spill file
+  uint64_t bytes;
+} Run;
+
+typedef struct {
+  FILE *f;       // Spill file holding the run
+  fpos_t pos;    // Where the next refill reads
+  uint64_t left; // Bytes of the run not read into buf yet
+  char *buf;
+  size_t len, off;
+  union {
+    int i;
+    double d;
+    char c;
+  } v;
+  char *s; // Current string (TYPE_STRING)
+  size_t cap;
+} RunCursor;
+
+static void report(ExtContext *ctx, double fraction) {
+  if (ctx->progress)
+    ctx->progress(fraction, ctx->user);
+}
+
+// Next token of the text format (separators: space, comma, CR, LF).
+// Returns its length, or -1 at end of file.
+static long read_token(FILE *f, char **tok, size_t *cap) {
+  int c;
+  do {
+    c = getc(f);
+  } while (c == ' ' || c == ',' || c == '\n' || c == '\r');
+  if (c == EOF)
+    return -1;
+  size_t len = 0;
+  while (c != EOF && c != ' ' && c != ',' && c != '\n' && c != '\r') {
+    if (len + 1 >= *cap) {
+      size_t ncap = *cap ? *cap * 2 : 64;
+      char *p = realloc(*tok, ncap);
+      if (!p)
+        return -1;
+      *tok = p;
+      *cap = ncap;
+    }
+    (*tok)[len++] = (char)c;
+    c = getc(f);
+  }
+  (*tok)[len] = 0;
+  return (long)len;
+}
+
+static FILE *new_spill(const ExtContext *ctx) {
+  FILE *f = tmpfile();
+  if (f)
+    setvbuf(f, NULL, _IOFBF, ctx->bufsize);
+  return f;
+}
+
+// Appends one value to the run being written at the end of f
+static int write_run_value(FILE *f, DataType t, const void *elem, Run *run) {
+  const void *src = t == TYPE_STRING ? *(char *const *)elem : elem;
+  size_t len = t == TYPE_STRING ? strlen(src) + 1 : get_element_size(t);
+  if (fwrite(src, 1, len, f) != len)
+    return -1;
+  run->bytes += len;
+  return 0;
+}
+
+// Numbers as the in-memory loaders read them back: doubles round-trip
+static void write_text_value(FILE *f, DataType t, const void *elem) {
+  char buf[32];
+  switch (t) {
+  case TYPE_INT:
+    fwrite(buf, 1, fmt_int64(buf, *(const int *)elem), f);
+    break;
+  case TYPE_DOUBLE:
+    fwrite(buf, 1, fmt_double(buf, *(const double *)elem), f);
+    break;
+  case TYPE_CHAR:
+    fprintf(f, "%c", *(const char *)elem);
+    break;
+  case TYPE_STRING:
+    fprintf(f, "%s", *(char *const *)elem);
+    break;
+  default:
+    break;
+  }
+}
+
+// Reads the next block of the run into the cursor buffer, which holds
+// bufsize bytes; returns -1 at the end of the run
+static int cursor_fill(RunCursor *c, size_t bufsize) {
+  if (c->left == 0)
+    return -1;
+  size_t n = c->left < bufsize ? (size_t)c->left : bufsize;
+  if (fsetpos(c->f, &c->pos) != 0 || fread(c->buf, 1, n, c->f) != n ||
+      fgetpos(c->f, &c->pos) != 0)
+    return -1;
+  c->left -= n;
+  c->len = n;
+  c->off = 0;
+  return 0;
+}
+
+static int cursor_read(RunCursor *c, void *dst, size_t n, size_t bufsize) {
+  char *d = dst;
+  while (n > 0) {
+    if (c->off == c->len && cursor_fill(c, bufsize) != 0)
+      return -1;
+    size_t k = c->len - c->off < n ? c->len - c->off : n;
+    memcpy(d, c->buf + c->off, k);
+    c->off += k;
+    d += k;
+    n -= k;
+  }
+  return 0;
+}
+
+// Loads the next value of a run into the cursor; returns 0, or -1 at the end
+static int cursor_next(RunCursor *c, DataType t, size_t bufsize) {
+  switch (t) {
+  case TYPE_INT:
+    return cursor_read(c, &c->v.i, sizeof(int), bufsize);
+  case TYPE_DOUBLE:
+    return cursor_read(c, &c->v.d, sizeof(double), bufsize);
+  case TYPE_CHAR:
+    return cursor_read(c, &c->v.c, 1, bufsize);
+  case TYPE_STRING: {
+    size_t len = 0;
+    for (;;) {
+      if (c->off == c->len && cursor_fill(c, bufsize) != 0)
+        return -1;
+      const char *p = c->buf + c->off;
+      const char *nul = memchr(p, 0, c->len - c->off);
+      size_t k = nul ? (size_t)(nul - p) + 1 : c->len - c->off;
+      if (len + k > c->cap) {
+        size_t ncap = c->cap ? c->cap : 64;
+        while (ncap < len + k)
+          ncap *= 2;
+        char *q = realloc(c->s, ncap);
+        if (!q)
+          return -1;
+        c->s = q;
+        c->cap = ncap;
+      }
+      memcpy(c->s + len, p, k);
+      len += k;
+      c->off += k;
+      if (nul)
+        return 0;
+    }
+  }
+  default:
+    return -1;
+  }
+}
+
+static const void *cursor_value(const RunCursor *c, DataType t) {
+  switch (t) {
+  case TYPE_INT:
+    return &c->v.i;
+  case TYPE_DOUBLE:
+    return &c->v.d;
+  case TYPE_CHAR:
+    return &c->v.c;
+  default:
+    return &c->s;
+  }
+}
+
+static int cursor_less(const RunCursor *a, const RunCursor *b, DataType t) {
+  switch (t) {
+  case TYPE_INT:
+    return a->v.i < b->v.i;
+  case TYPE_DOUBLE:
+    return a->v.d < b->v.d;
+  case TYPE_CHAR:
+    return a->v.c < b->v.c;
+  default:
+    return strcmp(a->s, b->s) < 0;
+  }
+}
+
+static void heap_sift(RunCursor *cur, int *heap, int n, int i,
+                      ExtContext *ctx) {
+  for (;;) {
+    int l = 2 * i + 1, m = i;
+    if (l >= n)
+      return;
+    ctx->stats->comparisons++;
+    if (cursor_less(&cur[heap[l]], &cur[heap[m]], ctx->type))
+      m = l;
+    if (l + 1 < n) {
+      ctx->stats->comparisons++;
+      if (cursor_less(&cur[heap[l + 1]], &cur[heap[m]], ctx->type))
+        m = l + 1;
+    }
+    if (m == i)
+      return;
+    int t = heap[i];
+    heap[i] = heap[m];
+    heap[m] = t;
+    i = m;
+  }
+}
+
+// k-way merge of runs[0..k) of spill file src into a run *out appended to
+// spill file bin (text == NULL), or into the text output.
+static int merge_runs(FILE *src, const Run *runs, int k, FILE *bin, Run *out,
+                      FILE *text, ExtContext *ctx) {
+  RunCursor *cur = calloc(k, sizeof(RunCursor));
+  int *heap = malloc(k * sizeof(int));
+  int n = 0, rc = 0;
+  if (!cur || !heap)
+    rc = -1;
+  for (int i = 0; rc == 0 && i < k; i++) {
+    cur[i].f = src;
+    cur[i].pos = runs[i].pos;
+    cur[i].left = runs[i].bytes;
+    cur[i].buf = malloc(ctx->bufsize);
+    if (!cur[i].buf)
+      rc = -1;
+    else if (cursor_next(&cur[i], ctx->type, ctx->bufsize) == 0)
+      heap[n++] = i;
+  }
+  if (rc == 0 && bin) {
+    out->bytes = 0;
+    if (fgetpos(bin, &out->pos) != 0)
+      rc = -1;
+  }
+  for (int i = n / 2 - 1; rc == 0 && i >= 0; i--)
+    heap_sift(cur, heap, n, i, ctx);
+
+  int first = 1;
+  while (rc == 0 && n > 0) {
+    RunCursor *top = &cur[heap[0]];
+    const void *v = cursor_value(top, ctx->type);
+    if (text) {
+      if (!first)
+        fputc(',', text);
+      write_text_value(text, ctx->type, v);
+      first = 0;
+    } else if (write_run_value(bin, ctx->type, v, out) != 0) {
+      rc = -1;
+      break;
+    }
+    ctx->stats->assignments++;
+    if (++ctx->merge_done % EXT_PROGRESS_STEP == 0)
+      report(ctx, 0.5 + 0.5 * ctx->merge_done / ctx->merge_total);
+
+    if (cursor_next(top, ctx->type, ctx->bufsize) != 0)
+      heap[0] = heap[--n];
+    heap_sift(cur, heap, n, 0, ctx);
+  }
+
+  for (int i = 0; cur && i < k; i++) {
+    free(cur[i].buf);
+    free(cur[i].s);
+  }
+  free(cur);
+  free(heap);
+  return rc;
+}
+
+// Phase 1: sorted runs of at most mem_limit bytes, all in the spill file
+// *spill_out. Returns the run count, or -1 on error. A single run is left in
+// memory (*chunk / *count) instead.
+static int make_runs(FILE *in, size_t mem_limit, FILE **spill_out,
+                     Run **runs_out, void **chunk_out, size_t *count_out,
+                     char **arena_out, ExtContext *ctx) {
+  DataType t = ctx->type;
+  size_t es = get_element_size(t);
+  // Strings: half the budget for bytes, a quarter for the pointers and a
+  // quarter for the multikey sort's scratch array.
+  size_t arena_cap = t == TYPE_STRING ? mem_limit / 2 : 0;
+  size_t cap = t == TYPE_STRING ? mem_limit / 4 / es : mem_limit / es;
+  void *chunk = malloc(cap * es);
+  char *arena = arena_cap ? malloc(arena_cap) : NULL;
+  char *tok = NULL;
+  size_t tok_cap = 0;
+  FILE *spill = NULL;
+  Run *runs = NULL;
+  int nruns = 0, rc = 0;
+  SortKernel sort = get_sort_kernel(
+      t, t == TYPE_STRING ? ALGO_MULTIKEY : ALGO_QUICK);
+  if (!chunk || (t == TYPE_STRING && !arena) || !sort)
+    rc = -1;
+
+  long fsize = 0, start = ftell(in);
+  if (fseek(in, 0, SEEK_END) == 0) {
+    fsize = ftell(in);
+    fseek(in, start, SEEK_SET);
+  }
+
+  long len = rc == 0 ? read_token(in, &tok, &tok_cap) : -1;
+  while (rc == 0 && len >= 0) {
+    size_t count = 0, used = 0;
+    while (len >= 0 && count < cap) {
+      if (t == TYPE_STRING) {
+        if (used + len + 1 > arena_cap) {
+          if (count > 0)
+            break;
+          // A single token larger than the arena: grow it
+          char *p = realloc(arena, len + 1);
+          if (!p) {
+            rc = -1;
+            break;
+          }
+          arena = p;
+          arena_cap = len + 1;
+        }
+        memcpy(arena + used, tok, len + 1);
+        ((char **)chunk)[count] = arena + used;
+        used += len + 1;
+      } else if (t == TYPE_INT) {
+        int64_t v = 0;
+        parse_int64(tok, tok + len, &v); // Unparsable tokens give 0
+        ((int *)chunk)[count] = (int)v;
+      } else if (t == TYPE_DOUBLE) {
+        double v = 0;
+        parse_double(tok, tok + len, &v);
+        ((double *)chunk)[count] = v;
+      } else
+        ((char *)chunk)[count] = tok[0];
+      count++;
+      len = read_token(in, &tok, &tok_cap);
+    }
+    if (rc != 0)
+      break;
+
+    sort(chunk, count, ctx->stats);
+    ctx->total += count;
+    if (fsize > 0)
+      report(ctx, 0.5 * (ftell(in) - start) / (fsize - start));
+
+    if (nruns == 0 && len < 0) {
+      // Everything fit in one chunk: no spill
+      *chunk_out = chunk;
+      *count_out = count;
+      *arena_out = arena;
+      free(tok);
+      *spill_out = NULL;
+      *runs_out = NULL;
+      return 0;
+    }
+
+    Run *p = realloc(runs, (nruns + 1) * sizeof(Run));
+    if (p)
+      runs = p;
+    if (!p || (!spill && !(spill = new_spill(ctx))) ||
+        fgetpos(spill, &runs[nruns].pos) != 0) {
+      rc = -1;
+      break;
+    }
+    Run *run = &runs[nruns++];
+    run->bytes = 0;
+    for (size_t i = 0; i < count && rc == 0; i++)
+      rc = write_run_value(spill, t, (char *)chunk + i * es, run);
+    ctx->stats->assignments += count;
+  }
+
+  free(chunk);
+  free(arena);
+  free(tok);
+  *chunk_out = NULL;
+  *count_out = 0;
+  *arena_out = NULL;
+  if (rc != 0) {
+    if (spill)
+      fclose(spill);
+    free(runs);
+    return -1;
+  }
+  *spill_out = spill;
+  *runs_out = runs;
+  return nruns;
+}
+
+int sort_external_file(const char *in_path, const char *out_path,
+                       size_t mem_limit, SortProgress progress, void *user,
+                       SortStats *stats) {
+  if (mem_limit < EXT_MIN_MEMORY)
+    mem_limit = EXT_MIN_MEMORY;
+  FILE *in = fopen(in_path, "rb");
+  if (!in)
+    return -1;
+  int type_int;
+  if (fscanf(in, "%d", &type_int) != 1 || type_int < TYPE_INT ||
+      type_int >= TYPE_CUSTOM) {
+    fclose(in);
+    return -1;
+  }
+
+  size_t bufsize = mem_limit / (EXT_FANIN + 2);
+  ExtContext ctx = {(DataType)type_int, stats, progress, user,
+                    bufsize > 4096 ? bufsize : 4096, 0, 0, 0};
+  FILE *spill;
+  Run *runs;
+  void *chunk;
+  size_t count;
+  char *arena;
+  int nruns = make_runs(in, mem_limit, &spill, &runs, &chunk, &count, &arena,
+                        &ctx);
+  fclose(in);
+  if (nruns < 0)
+    return -1;
+
+  FILE *out = fopen(out_path, "w");
+  if (!out) {
+    if (spill)
+      fclose(spill);
+    free(runs);
+    free(chunk);
+    free(arena);
+    return -1;
+  }
+  fprintf(out, "%d\n", type_int);
+
+  int rc = 0;
+  if (nruns == 0) {
+    size_t es = get_element_size(ctx.type);
+    for (size_t i = 0; i < count; i++) {
+      if (i > 0)
+        fputc(',', out);
+      write_text_value(out, ctx.type, (char *)chunk + i * es);
+    }
+    free(chunk);
+    free(arena);
+  } else {
+    int passes = 1;
+    for (int r = nruns; r > EXT_FANIN; r = (r + EXT_FANIN - 1) / EXT_FANIN)
+      passes++;
+    ctx.merge_total = ctx.total * passes;
+
+    // Intermediate passes: groups of EXT_FANIN runs into one run each, from
+    // the spill file into the next one
+    while (rc == 0 && nruns > EXT_FANIN) {
+      FILE *dst = new_spill(&ctx);
+      int merged = 0;
+      rc = dst ? 0 : -1;
+      for (int i = 0; rc == 0 && i < nruns; i += EXT_FANIN) {
+        int k = nruns - i < EXT_FANIN ? nruns - i : EXT_FANIN;
+        Run run; // runs[merged] may be one of the inputs
+        rc = merge_runs(spill, runs + i, k, dst, &run, NULL, &ctx);
+        runs[merged++] = run;
+      }
+      fclose(spill);
+      spill = dst;
+      nruns = merged;
+    }
+    if (rc == 0)
+      rc = merge_runs(spill, runs, nruns, NULL, NULL, out, &ctx);
+    if (spill)
+      fclose(spill);
+    free(runs);
+  }
+
+  if (fclose(out) != 0)
+    rc = -1;
+  if (rc == 0)
+    report(&ctx, 1.0);
+  return rc;
+}
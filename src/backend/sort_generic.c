@@ -0,0 +1,23 @@
+#include "backend.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Generic sorts over void* elements of any size, ordered by a CompareFunc.
+// Elements move through memcpy; only TYPE_CUSTOM data should land here, the
+// built-in types have specialized kernels in sort_typed.c.
+// The kernels live in sort_generic_template.h and are built twice: counting
+// operations (sort_*_gen) and without counting (sort_*_gen_clean).
+
+static void swap_gen(void *a, void *b, size_t size) {
+  char temp[size];
+  memcpy(temp, a, size);
+  memcpy(a, b, size);
+  memcpy(b, temp, size);
+}
+
+#define GEN_SUFFIX gen
+#include "sort_generic_template.h"
+
+#define GEN_SUFFIX gen_clean
+#define GEN_NO_STATS
+#include "sort_generic_template.h"
@@ -0,0 +1,235 @@
+#include "backend.h"
+#include <limits.h>
+#include <math.h>
+
+// Register-resident bitonic sorting networks for small int/double blocks,
+// used as the introsort base case. A block of up to SORT_NETWORK_MAX values
+// is padded with +max sentinels to 1, 2, 4 or 8 (int) / 16 (double) AVX2
+// registers, each register is sorted in place with lane shuffles and
+// min/max, then sorted registers are merged pairwise with bitonic merges.
+// No branch depends on the data. min/max return their second operand when
+// either one is NaN, which would duplicate some values and drop others, so
+// double blocks holding a NaN go to the scalar fallback instead.
+//
+// Statistics: every vector min/max pair counts one comparison per lane, and
+// each element is loaded and stored once (2n assignments).
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_AVX2_NETWORK 1
+#include <immintrin.h>
+#endif
+
+int sort_network_available(void) {
+#ifdef HAVE_AVX2_NETWORK
+  // Racing first callers compute and store the same value
+  static atomic_int avx2 = -1;
+  int have = atomic_load_explicit(&avx2, memory_order_relaxed);
+  if (have < 0) {
+    have = __builtin_cpu_supports("avx2") ? 1 : 0;
+    atomic_store_explicit(&avx2, have, memory_order_relaxed);
+  }
+  return have;
+#else
+  return 0;
+#endif
+}
+
+#ifdef HAVE_AVX2_NETWORK
+
+// --- int: 8 lanes per register ---
+
+// One compare-exchange stage inside a register: partner lane is i ^ j, and
+// lanes whose bit is set in `mask` keep the max.
+#define STAGE_I32(v, perm, mask)                                               \
+  do {                                                                         \
+    __m256i p_ = (perm);                                                       \
+    __m256i lo_ = _mm256_min_epi32((v), p_);                                   \
+    __m256i hi_ = _mm256_max_epi32((v), p_);                                   \
+    (v) = _mm256_blend_epi32(lo_, hi_, (mask));                                \
+  } while (0)
+
+#define SWAP1_I32(v) _mm256_shuffle_epi32((v), _MM_SHUFFLE(2, 3, 0, 1))
+#define SWAP2_I32(v) _mm256_shuffle_epi32((v), _MM_SHUFFLE(1, 0, 3, 2))
+#define SWAP4_I32(v) _mm256_permute2x128_si256((v), (v), 1)
+
+__attribute__((target("avx2"))) static __m256i sort8_i32(__m256i v) {
+  STAGE_I32(v, SWAP1_I32(v), 0x66);
+  STAGE_I32(v, SWAP2_I32(v), 0x3C);
+  STAGE_I32(v, SWAP1_I32(v), 0x5A);
+  STAGE_I32(v, SWAP4_I32(v), 0xF0);
+  STAGE_I32(v, SWAP2_I32(v), 0xCC);
+  STAGE_I32(v, SWAP1_I32(v), 0xAA);
+  return v;
+}
+
+// Sorts a bitonic register ascending
+__attribute__((target("avx2"))) static __m256i merge8_i32(__m256i v) {
+  STAGE_I32(v, SWAP4_I32(v), 0xF0);
+  STAGE_I32(v, SWAP2_I32(v), 0xCC);
+  STAGE_I32(v, SWAP1_I32(v), 0xAA);
+  return v;
+}
+
+__attribute__((target("avx2"))) static __m256i reverse_i32(__m256i v) {
+  return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1,
+                                                          0));
+}
+
+// Bitonic sequence spread over m registers -> ascending
+__attribute__((target("avx2"))) static void bitonic_i32(__m256i *r, int m) {
+  for (int d = m / 2; d > 0; d /= 2)
+    for (int i = 0; i < m; i++)
+      if ((i & d) == 0) {
+        __m256i lo = _mm256_min_epi32(r[i], r[i + d]);
+        r[i + d] = _mm256_max_epi32(r[i], r[i + d]);
+        r[i] = lo;
+      }
+  for (int i = 0; i < m; i++)
+    r[i] = merge8_i32(r[i]);
+}
+
+__attribute__((target("avx2"))) static void network_avx2_int(int *arr,
+                                                             size_t n) {
+  int buf[SORT_NETWORK_MAX];
+  int regs = 1;
+  while ((size_t)regs * 8 < n)
+    regs *= 2;
+  for (size_t i = 0; i < (size_t)regs * 8; i++)
+    buf[i] = i < n ? arr[i] : INT_MAX;
+
+  __m256i r[SORT_NETWORK_MAX / 8];
+  for (int i = 0; i < regs; i++)
+    r[i] = sort8_i32(_mm256_loadu_si256((const __m256i *)(buf + 8 * i)));
+
+  // Merge sorted runs of `run` registers pairwise: reverse the second run so
+  // the pair is bitonic, split min/max, then sort both halves.
+  for (int run = 1; run < regs; run *= 2) {
+    for (int b = 0; b < regs; b += 2 * run) {
+      __m256i *x = r + b, *y = r + b + run;
+      for (int i = 0; i < run / 2; i++) {
+        __m256i t = y[i];
+        y[i] = y[run - 1 - i];
+        y[run - 1 - i] = t;
+      }
+      for (int i = 0; i < run; i++) {
+        __m256i ry = reverse_i32(y[i]);
+        y[i] = _mm256_max_epi32(x[i], ry);
+        x[i] = _mm256_min_epi32(x[i], ry);
+      }
+      bitonic_i32(x, run);
+      bitonic_i32(y, run);
+    }
+  }
+
+  for (int i = 0; i < regs; i++)
+    _mm256_storeu_si256((__m256i *)(buf + 8 * i), r[i]);
+  for (size_t i = 0; i < n; i++)
+    arr[i] = buf[i];
+}
+
+// --- double: 4 lanes per register ---
+
+#define STAGE_F64(v, perm, mask)                                               \
+  do {                                                                         \
+    __m256d p_ = (perm);                                                       \
+    __m256d lo_ = _mm256_min_pd((v), p_);                                      \
+    __m256d hi_ = _mm256_max_pd((v), p_);                                      \
+    (v) = _mm256_blend_pd(lo_, hi_, (mask));                                   \
+  } while (0)
+
+#define SWAP1_F64(v) _mm256_permute_pd((v), 0x5)
+#define SWAP2_F64(v) _mm256_permute2f128_pd((v), (v), 1)
+
+__attribute__((target("avx2"))) static __m256d sort4_f64(__m256d v) {
+  STAGE_F64(v, SWAP1_F64(v), 0x6);
+  STAGE_F64(v, SWAP2_F64(v), 0xC);
+  STAGE_F64(v, SWAP1_F64(v), 0xA);
+  return v;
+}
+
+__attribute__((target("avx2"))) static __m256d merge4_f64(__m256d v) {
+  STAGE_F64(v, SWAP2_F64(v), 0xC);
+  STAGE_F64(v, SWAP1_F64(v), 0xA);
+  return v;
+}
+
+__attribute__((target("avx2"))) static void bitonic_f64(__m256d *r, int m) {
+  for (int d = m / 2; d > 0; d /= 2)
+    for (int i = 0; i < m; i++)
+      if ((i & d) == 0) {
+        __m256d lo = _mm256_min_pd(r[i], r[i + d]);
+        r[i + d] = _mm256_max_pd(r[i], r[i + d]);
+        r[i] = lo;
+      }
+  for (int i = 0; i < m; i++)
+    r[i] = merge4_f64(r[i]);
+}
+
+// Returns 0, leaving arr untouched, if the block holds a NaN
+__attribute__((target("avx2"))) static int network_avx2_double(double *arr,
+                                                               size_t n) {
+  double buf[SORT_NETWORK_MAX];
+  int regs = 1;
+  while ((size_t)regs * 4 < n)
+    regs *= 2;
+  for (size_t i = 0; i < (size_t)regs * 4; i++)
+    buf[i] = i < n ? arr[i] : HUGE_VAL;
+
+  __m256d r[SORT_NETWORK_MAX / 4];
+  __m256d unordered = _mm256_setzero_pd();
+  for (int i = 0; i < regs; i++) {
+    r[i] = _mm256_loadu_pd(buf + 4 * i);
+    unordered =
+        _mm256_or_pd(unordered, _mm256_cmp_pd(r[i], r[i], _CMP_UNORD_Q));
+  }
+  if (_mm256_movemask_pd(unordered))
+    return 0;
+  for (int i = 0; i < regs; i++)
+    r[i] = sort4_f64(r[i]);
+
+  for (int run = 1; run < regs; run *= 2) {
+    for (int b = 0; b < regs; b += 2 * run) {
+      __m256d *x = r + b, *y = r + b + run;
+      for (int i = 0; i < run / 2; i++) {
+        __m256d t = y[i];
+        y[i] = y[run - 1 - i];
+        y[run - 1 - i] = t;
+      }
+      for (int i = 0; i < run; i++) {
+        __m256d ry = _mm256_permute4x64_pd(y[i], _MM_SHUFFLE(0, 1, 2, 3));
+        y[i] = _mm256_max_pd(x[i], ry);
+        x[i] = _mm256_min_pd(x[i], ry);
+      }
+      bitonic_f64(x, run);
+      bitonic_f64(y, run);
+    }
+  }
+
+  for (int i = 0; i < regs; i++)
+    _mm256_storeu_pd(buf + 4 * i, r[i]);
+  for (size_t i = 0; i < n; i++)
+    arr[i] = buf[i];
+  return 1;
+}
+
+#endif
+
+// Comparator count of the padded network: in-register sort, then for each
+// merge level one min/max split plus log2(lanes * run) bitonic stages.
+static unsigned long network_comparisons(size_t n, int lanes, int log_lanes) {
+  size_t regs = 1;
+  while (regs * lanes < n)
+    regs *= 2;
+  unsigned long stages = (unsigned long)log_lanes * (log_lanes + 1) / 2;
+  unsigned long total = stages * regs;
+  int level = 1;
+  for (size_t run = 1; run < regs; run *= 2, level++)
+    total += regs * (1 + log_lanes + level - 1);
+  return total * lanes / 2;
+}
+
+// Entry points and scalar fallbacks, with and without operation counting
+#include "sort_network_template.h"
+
+#define SORT_NO_STATS
+#include "sort_network_template.h"
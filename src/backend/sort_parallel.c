@@ -0,0 +1,254 @@
+#include "backend.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Multithreaded drivers over SortOps. Each thread accumulates into its own
+// SortStats; the caller's stats receive the sum once every thread joined.
+
+// Set by the GUI thread while a comparison thread may be sorting
+static atomic_int par_threads = 0; // <= 0: one per online core
+static atomic_size_t par_cutoff = 16384;
+
+void sort_parallel_config(int threads, size_t cutoff) {
+  atomic_store(&par_threads, threads);
+  atomic_store(&par_cutoff, cutoff > 0 ? cutoff : 1);
+}
+
+int sort_parallel_threads(void) {
+  int threads = atomic_load(&par_threads);
+  if (threads > 0)
+    return threads;
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+#endif
+}
+
+size_t sort_parallel_cutoff(void) { return atomic_load(&par_cutoff); }
+
+static void stats_add(SortStats *dst, const SortStats *src) {
+  dst->comparisons += src->comparisons;
+  dst->assignments += src->assignments;
+  dst->avoided += src->avoided;
+}
+
+// --- Parallel Quick Sort (task-parallel recursion) ---
+// After each partition the left side goes to a new thread while the current
+// thread keeps the right side, until the spawn depth (log2(threads) + 1,
+// i.e. about two tasks per core) or the cutoff is reached. Leaves run the
+// sequential introsort, which also bounds the worst case.
+
+typedef struct {
+  char *base;
+  size_t n;
+  const SortOps *ops;
+  int depth;
+  size_t cutoff;
+  SortStats stats;
+} QuickTask;
+
+static void pquick_rec(char *base, size_t n, const SortOps *ops, int depth,
+                       size_t cutoff, SortStats *stats);
+
+static void *pquick_thread(void *arg) {
+  QuickTask *t = arg;
+  pquick_rec(t->base, t->n, t->ops, t->depth, t->cutoff, &t->stats);
+  return NULL;
+}
+
+static void pquick_rec(char *base, size_t n, const SortOps *ops, int depth,
+                       size_t cutoff, SortStats *stats) {
+  if (n <= cutoff || depth == 0) {
+    ops->sort(base, n, stats);
+    return;
+  }
+  size_t p = ops->partition(base, 0, n, stats);
+
+  QuickTask left = {base, p, ops, depth - 1, cutoff, {0, 0, 0}};
+  pthread_t tid;
+  int spawned = pthread_create(&tid, NULL, pquick_thread, &left) == 0;
+  if (!spawned)
+    pquick_thread(&left);
+
+  pquick_rec(base + (p + 1) * ops->size, n - p - 1, ops, depth - 1, cutoff,
+             stats);
+
+  if (spawned)
+    pthread_join(tid, NULL);
+  stats_add(stats, &left.stats);
+}
+
+void sort_parallel_quick(void *base, size_t n, const SortOps *ops,
+                         SortStats *stats) {
+  if (n < 2)
+    return;
+  int depth = 1;
+  for (int t = sort_parallel_threads(); t > 1; t = (t + 1) / 2)
+    depth++;
+  pquick_rec(base, n, ops, depth, sort_parallel_cutoff(), stats);
+}
+
+// --- Parallel Merge Sort ---
+// Phase 1 sorts one chunk per thread with the sequential kernel. Phase 2
+// merges runs pairwise, round after round, ping-ponging between the array
+// and one scratch buffer. Each pairwise merge is itself cut into independent
+// pieces (split points found by binary search in the other run) so the last
+// rounds, with few runs left, still keep every thread busy.
+
+typedef struct {
+  const SortOps *ops;
+  const char *a, *b; // Inputs (b unused when sorting a chunk)
+  size_t na, nb;
+  char *out;
+  SortStats stats;
+} MergeTask;
+
+static void *chunk_thread(void *arg) {
+  MergeTask *t = arg;
+  t->ops->sort(t->out, t->na, &t->stats);
+  return NULL;
+}
+
+static void *merge_thread(void *arg) {
+  MergeTask *t = arg;
+  t->ops->merge(t->a, t->na, t->b, t->nb, t->out, &t->stats);
+  return NULL;
+}
+
+// Runs tasks[1..count) on new threads and tasks[0] on the caller
+static void run_tasks(MergeTask *tasks, int count, void *(*fn)(void *),
+                      SortStats *stats) {
+  pthread_t *tids = malloc(count * sizeof(pthread_t));
+  int *spawned = calloc(count, sizeof(int));
+  for (int i = 1; i < count; i++) {
+    spawned[i] = tids && spawned &&
+                 pthread_create(&tids[i], NULL, fn, &tasks[i]) == 0;
+    if (!spawned[i])
+      fn(&tasks[i]);
+  }
+  fn(&tasks[0]);
+  for (int i = 0; i < count; i++) {
+    if (spawned && spawned[i])
+      pthread_join(tids[i], NULL);
+    stats_add(stats, &tasks[i].stats);
+  }
+  free(tids);
+  free(spawned);
+}
+
+// Splits merge(a, b) -> out into `pieces` tasks, cutting the longer run
+// evenly. Every piece merges a part of a with the part of b that follows it,
+// so equal keys keep a's before b's, as in one sequential merge: a cut
+// before a[i] sends the b elements less than a[i] to the left, a cut before
+// b[j] the a elements not greater than b[j].
+static int split_merge(const SortOps *ops, const char *a, size_t na,
+                       const char *b, size_t nb, char *out, int pieces,
+                       MergeTask *tasks) {
+  size_t es = ops->size;
+  int cut_b = nb > na;
+  size_t prev_i = 0, prev_j = 0;
+  int count = 0;
+  for (int k = 1; k <= pieces; k++) {
+    size_t i = na, j = nb;
+    if (k < pieces && cut_b) {
+      j = nb * k / pieces;
+      i = ops->upper_bound(a, na, b + j * es);
+    } else if (k < pieces) {
+      i = na * k / pieces;
+      j = ops->lower_bound(b, nb, a + i * es);
+    }
+    if (i == prev_i && j == prev_j)
+      continue;
+    MergeTask t = {ops,        a + prev_i * es, b + prev_j * es,
+                   i - prev_i, j - prev_j,      out + (prev_i + prev_j) * es,
+                   {0, 0, 0}};
+    tasks[count++] = t;
+    prev_i = i;
+    prev_j = j;
+  }
+  return count;
+}
+
+void sort_parallel_merge(void *base, size_t n, const SortOps *ops,
+                         SortStats *stats) {
+  if (n < 2)
+    return;
+  size_t es = ops->size;
+  int threads = sort_parallel_threads();
+  size_t cutoff = sort_parallel_cutoff();
+  if ((size_t)threads > n / cutoff)
+    threads = (int)(n / cutoff);
+  char *buf = threads > 1 ? malloc(n * es) : NULL;
+  MergeTask *tasks = threads > 1 ? malloc(threads * sizeof(MergeTask)) : NULL;
+  size_t *bounds = threads > 1 ? malloc((threads + 1) * sizeof(size_t)) : NULL;
+  if (!buf || !tasks || !bounds) {
+    free(buf);
+    free(tasks);
+    free(bounds);
+    ops->sort(base, n, stats);
+    return;
+  }
+
+  // Phase 1: one chunk per thread
+  for (int k = 0; k <= threads; k++)
+    bounds[k] = n * k / threads;
+  for (int k = 0; k < threads; k++) {
+    MergeTask t = {ops, NULL, NULL, bounds[k + 1] - bounds[k], 0,
+                   (char *)base + bounds[k] * es, {0, 0, 0}};
+    tasks[k] = t;
+  }
+  run_tasks(tasks, threads, chunk_thread, stats);
+
+  // Phase 2: pairwise merge rounds, each merge split across the threads
+  char *src = base, *dst = buf;
+  int runs = threads;
+  while (runs > 1) {
+    int pairs = runs / 2;
+    int per_pair = threads / pairs > 0 ? threads / pairs : 1;
+    MergeTask *round = tasks; // pairs * per_pair <= threads
+    int count = 0;
+    for (int r = 0; r + 1 < runs; r += 2) {
+      size_t lo = bounds[r], mid = bounds[r + 1], hi = bounds[r + 2];
+      count += split_merge(ops, src + lo * es, mid - lo, src + mid * es,
+                           hi - mid, dst + lo * es, per_pair, round + count);
+    }
+    if (runs % 2) {
+      // Odd run out: carried over as-is
+      size_t lo = bounds[runs - 1], hi = bounds[runs];
+      memcpy(dst + lo * es, src + lo * es, (hi - lo) * es);
+      stats->assignments += hi - lo;
+    }
+    if (count > 0)
+      run_tasks(round, count, merge_thread, stats);
+
+    // Drop every other boundary
+    int kept = 0;
+    for (int k = 0; k <= runs; k += 2)
+      bounds[kept++] = bounds[k];
+    if (runs % 2)
+      bounds[kept++] = bounds[runs];
+    runs = kept - 1;
+
+    char *t = src;
+    src = dst;
+    dst = t;
+  }
+
+  if (src != (char *)base) {
+    memcpy(base, src, n * es);
+    stats->assignments += n;
+  }
+  free(buf);
+  free(tasks);
+  free(bounds);
+}
@@ -0,0 +1,67 @@
+#include "backend.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// String sort on char ** arrays without full strcmp calls: partitions look
+// at a single byte position (depth) at a time, so a common prefix is read
+// once per level instead of once per comparison.
+//  - Large partitions: one MSD radix pass, 256 buckets on byte `depth`
+//    (bucket 0 = string ended, already in final order).
+//  - Medium partitions: Bentley-Sedgewick three-way radix quicksort; the
+//    "equal" part moves on to depth + 1.
+//  - Small partitions: insertion sort comparing from `depth` on.
+// Statistics: every byte inspected counts as one comparison, pointer moves
+// count as assignments (a swap is 3). The kernels of this file live in
+// sort_string_template.h, built with and without counting like the typed
+// sorts.
+
+#define MKQS_CUTOFF 16
+#define MSD_THRESHOLD 4096
+
+#define CH(s, d) ((unsigned char)(s)[d])
+
+static void swap_str(char **a, char **b) {
+  char *t = *a;
+  *a = *b;
+  *b = t;
+}
+
+// --- Cached-prefix sort ---
+// Introsort over (prefix, pointer) pairs: the first 8 bytes of each string,
+// big-endian in a uint64_t, so integer order is strcmp order on the prefix.
+// Comparisons read the inline keys; only equal keys of strings longer than
+// 7 bytes dereference the pointers for strcmp on the rest. stats->avoided
+// counts the comparisons settled by the keys alone.
+
+#define PREFIX_CUTOFF 16
+
+typedef struct {
+  uint64_t key;
+  char *s;
+} PrefixEntry;
+
+static uint64_t load_prefix(const char *s) {
+  // Built most significant byte first, so bytes past the end stay zero
+  // (no shift by 64 for the empty string)
+  uint64_t key = 0;
+  for (int i = 0; i < 8 && s[i]; i++)
+    key |= (uint64_t)(unsigned char)s[i] << (8 * (7 - i));
+  return key;
+}
+
+static void prefix_swap(PrefixEntry *a, PrefixEntry *b) {
+  PrefixEntry t = *a;
+  *a = *b;
+  *b = t;
+}
+
+// --- Instantiations ---
+// Each pulls both kernels from sort_string_template.h
+
+#define SS_SUFFIX str
+#include "sort_string_template.h"
+
+#define SS_SUFFIX str_clean
+#define SORT_NO_STATS
+#include "sort_string_template.h"
@@ -0,0 +1,128 @@
+#include "backend.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Recording and replay of sort traces. The traced kernels (sort_typed.c)
+// call sort_trace_emit, inlined from backend.h: one counter increment and
+// one 8-byte store per event, plus folding the evicted event into the base
+// slots once the ring has wrapped. Replay moves input indices around rather
+// than elements, so it works the same for every DataType.
+
+SortTrace *sort_trace_active;
+
+int sort_trace_init(SortTrace *t, size_t n, size_t capacity) {
+  memset(t, 0, sizeof(*t));
+  if (n > TRACE_MAX_N)
+    return -1;
+  size_t cap = 1;
+  while (cap < capacity)
+    cap <<= 1;
+  t->events = malloc(cap * sizeof(TraceEvent));
+  t->slots = malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+  if (!t->events || !t->slots) {
+    sort_trace_free(t);
+    return -1;
+  }
+  t->mask = cap - 1;
+  t->n = n;
+  return 0;
+}
+
+void sort_trace_free(SortTrace *t) {
+  free(t->events);
+  free(t->slots);
+  memset(t, 0, sizeof(*t));
+}
+
+uint64_t sort_trace_first(const SortTrace *t) {
+  return t->total > t->mask + 1 ? t->total - (t->mask + 1) : 0;
+}
+
+TraceEvent sort_trace_event(const SortTrace *t, uint64_t k) {
+  return t->events[k & t->mask];
+}
+
+int sort_traced(SortTrace *trace, void *base, size_t n, DataType t,
+                SortAlgo algo, SortStats *stats) {
+  SortKernel kernel = get_sort_kernel_traced(t, algo);
+  if (!kernel || n > trace->n)
+    return -1;
+  trace->total = 0;
+  trace->temp = TRACE_TEMP; // Nothing held aside yet
+  for (size_t i = 0; i < n; i++)
+    trace->slots[i] = (uint32_t)i;
+  sort_trace_active = trace;
+  kernel(base, n, stats);
+  sort_trace_active = NULL;
+  return 0;
+}
+
+// --- Replay ---
+
+int sort_replay_init(SortReplay *r, const SortTrace *trace) {
+  memset(r, 0, sizeof(*r));
+  r->trace = trace;
+  r->slots = malloc((trace->n > 0 ? trace->n : 1) * sizeof(uint32_t));
+  if (!r->slots)
+    return -1;
+  memcpy(r->slots, trace->slots, trace->n * sizeof(uint32_t));
+  r->temp = trace->temp;
+  r->pos = sort_trace_first(trace);
+  uint64_t len = trace->total - r->pos;
+  r->key_every = (len + SORT_REPLAY_KEYFRAMES - 1) / SORT_REPLAY_KEYFRAMES;
+  if (r->key_every == 0)
+    r->key_every = 1;
+  return 0;
+}
+
+void sort_replay_free(SortReplay *r) {
+  free(r->slots);
+  for (int k = 0; k < SORT_REPLAY_KEYFRAMES; k++)
+    free(r->keys[k]);
+  memset(r, 0, sizeof(*r));
+}
+
+// Keyframe 0 is the trace's own base; the others are copied on the way
+static void take_keyframe(SortReplay *r, uint64_t k) {
+  size_t bytes = r->trace->n * sizeof(uint32_t);
+  if (k == 0 || k >= SORT_REPLAY_KEYFRAMES || r->keys[k])
+    return;
+  r->keys[k] = malloc(bytes > 0 ? bytes : 1);
+  if (r->keys[k]) {
+    memcpy(r->keys[k], r->slots, bytes);
+    r->key_temp[k] = r->temp;
+  }
+}
+
+void sort_replay_seek(SortReplay *r, uint64_t pos) {
+  const SortTrace *t = r->trace;
+  uint64_t first = sort_trace_first(t);
+  if (pos < first)
+    pos = first;
+  if (pos > t->total)
+    pos = t->total;
+
+  if (pos < r->pos) {
+    uint64_t k = (pos - first) / r->key_every;
+    if (k >= SORT_REPLAY_KEYFRAMES)
+      k = SORT_REPLAY_KEYFRAMES - 1;
+    while (k > 0 && !r->keys[k])
+      k--;
+    const uint32_t *from = k > 0 ? r->keys[k] : t->slots;
+    memcpy(r->slots, from, t->n * sizeof(uint32_t));
+    r->temp = k > 0 ? r->key_temp[k] : t->temp;
+    r->pos = first + k * r->key_every;
+  }
+
+  // Forward, one keyframe interval at a time
+  while (r->pos < pos) {
+    uint64_t off = r->pos - first;
+    if (off % r->key_every == 0)
+      take_keyframe(r, off / r->key_every);
+    uint64_t stop = first + (off / r->key_every + 1) * r->key_every;
+    if (stop > pos)
+      stop = pos;
+    for (; r->pos < stop; r->pos++)
+      sort_trace_apply(r->slots, &r->temp, sort_trace_event(t, r->pos));
+  }
+}
@@ -0,0 +1,251 @@
+#include "backend.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Type-specialized sort kernels. Each block below stamps out the comparison
+// sorts and selection kernels of sort_template.h with an inlined comparison
+// and plain typed moves, so the compiler sees through every access. Every
+// type is instantiated three times: with operation counting
+// (get_sort_kernel), with counting compiled out, suffix _clean
+// (get_sort_kernel_clean), for timing, and with trace recording, suffix
+// _traced (get_sort_kernel_traced), which has no sorting network, whose moves
+// the trace could not show.
+
+#define SORT_T int
+#define SORT_SUFFIX int
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NETWORK sort_network_int
+#include "sort_template.h"
+
+#define SORT_T double
+#define SORT_SUFFIX double
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NETWORK sort_network_double
+#include "sort_template.h"
+
+#define SORT_T char
+#define SORT_SUFFIX char
+#define SORT_LESS(a, b) ((a) < (b))
+#include "sort_template.h"
+
+#define SORT_T char *
+#define SORT_SUFFIX str
+#define SORT_LESS(a, b) (strcmp((a), (b)) < 0)
+#include "sort_template.h"
+
+#define SORT_T int
+#define SORT_SUFFIX int_clean
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NETWORK sort_network_int_clean
+#define SORT_NO_STATS
+#include "sort_template.h"
+
+#define SORT_T double
+#define SORT_SUFFIX double_clean
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NETWORK sort_network_double_clean
+#define SORT_NO_STATS
+#include "sort_template.h"
+
+#define SORT_T char
+#define SORT_SUFFIX char_clean
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_NO_STATS
+#include "sort_template.h"
+
+#define SORT_T char *
+#define SORT_SUFFIX str_clean
+#define SORT_LESS(a, b) (strcmp((a), (b)) < 0)
+#define SORT_NO_STATS
+#include "sort_template.h"
+
+#define SORT_T int
+#define SORT_SUFFIX int_traced
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_TRACE
+#include "sort_template.h"
+
+#define SORT_T double
+#define SORT_SUFFIX double_traced
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_TRACE
+#include "sort_template.h"
+
+#define SORT_T char
+#define SORT_SUFFIX char_traced
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_TRACE
+#include "sort_template.h"
+
+#define SORT_T char *
+#define SORT_SUFFIX str_traced
+#define SORT_LESS(a, b) (strcmp((a), (b)) < 0)
+#define SORT_TRACE
+#include "sort_template.h"
+
+// --- Non-comparison kernels behind the SortKernel signature ---
+// Each has a _clean build, like the sorting networks under the clean
+// introsorts, so nothing the clean table reaches updates stats.
+
+static void quick_int_counting(void *base, size_t n, SortStats *stats) {
+  // Small key ranges are histogrammed; sort_counting_int leaves the pre-scan
+  // cost in stats when it declines.
+  if (!sort_counting_int(base, n, stats))
+    sort_quick_int(base, n, stats);
+}
+
+static void quick_int_counting_clean(void *base, size_t n, SortStats *stats) {
+  if (!sort_counting_int_clean(base, n, stats))
+    sort_quick_int_clean(base, n, stats);
+}
+
+static void quick_char_counting(void *base, size_t n, SortStats *stats) {
+  sort_counting_char(base, n, stats);
+}
+
+static void quick_char_counting_clean(void *base, size_t n,
+                                      SortStats *stats) {
+  sort_counting_char_clean(base, n, stats);
+}
+
+static void radix_int(void *base, size_t n, SortStats *stats) {
+  sort_radix_int(base, n, stats);
+}
+
+static void radix_int_clean(void *base, size_t n, SortStats *stats) {
+  sort_radix_int_clean(base, n, stats);
+}
+
+static void radix_double(void *base, size_t n, SortStats *stats) {
+  sort_radix_double(base, n, stats);
+}
+
+static void radix_double_clean(void *base, size_t n, SortStats *stats) {
+  sort_radix_double_clean(base, n, stats);
+}
+
+static void multikey_str(void *base, size_t n, SortStats *stats) {
+  sort_multikey_str(base, n, stats);
+}
+
+static void multikey_str_clean(void *base, size_t n, SortStats *stats) {
+  sort_multikey_str_clean(base, n, stats);
+}
+
+static void prefix_str(void *base, size_t n, SortStats *stats) {
+  sort_prefix_str(base, n, stats);
+}
+
+static void prefix_str_clean(void *base, size_t n, SortStats *stats) {
+  sort_prefix_str_clean(base, n, stats);
+}
+
+// --- Dispatch ---
+
+size_t get_element_size(DataType t) {
+  switch (t) {
+  case TYPE_INT:
+    return sizeof(int);
+  case TYPE_DOUBLE:
+    return sizeof(double);
+  case TYPE_CHAR:
+    return sizeof(char);
+  case TYPE_STRING:
+    return sizeof(char *);
+  default:
+    return 0;
+  }
+}
+
+SortKernel get_sort_kernel(DataType t, SortAlgo algo) {
+  static const SortKernel table[TYPE_CUSTOM][ALGO_COUNT] = {
+      [TYPE_INT] = {sort_bubble_int, sort_insertion_int, sort_shell_int,
+                    quick_int_counting, radix_int, sort_par_quick_int,
+                    sort_par_merge_int, NULL, sort_natural_int},
+      [TYPE_DOUBLE] = {sort_bubble_double, sort_insertion_double,
+                       sort_shell_double, sort_quick_double, radix_double,
+                       sort_par_quick_double, sort_par_merge_double, NULL,
+                       sort_natural_double},
+      [TYPE_CHAR] = {sort_bubble_char, sort_insertion_char, sort_shell_char,
+                     quick_char_counting, NULL, sort_par_quick_char,
+                     sort_par_merge_char, NULL, sort_natural_char},
+      [TYPE_STRING] = {sort_bubble_str, sort_insertion_str, sort_shell_str,
+                       sort_quick_str, NULL, sort_par_quick_str,
+                       sort_par_merge_str, multikey_str, sort_natural_str,
+                       prefix_str},
+  };
+  if ((unsigned)t >= TYPE_CUSTOM || (unsigned)algo >= ALGO_COUNT)
+    return NULL;
+  return table[t][algo];
+}
+
+SortKernel get_sort_kernel_clean(DataType t, SortAlgo algo) {
+  static const SortKernel table[TYPE_CUSTOM][ALGO_COUNT] = {
+      [TYPE_INT] = {sort_bubble_int_clean, sort_insertion_int_clean,
+                    sort_shell_int_clean, quick_int_counting_clean,
+                    radix_int_clean, sort_par_quick_int_clean,
+                    sort_par_merge_int_clean, NULL, sort_natural_int_clean},
+      [TYPE_DOUBLE] = {sort_bubble_double_clean, sort_insertion_double_clean,
+                       sort_shell_double_clean, sort_quick_double_clean,
+                       radix_double_clean, sort_par_quick_double_clean,
+                       sort_par_merge_double_clean, NULL,
+                       sort_natural_double_clean},
+      [TYPE_CHAR] = {sort_bubble_char_clean, sort_insertion_char_clean,
+                     sort_shell_char_clean, quick_char_counting_clean, NULL,
+                     sort_par_quick_char_clean, sort_par_merge_char_clean,
+                     NULL, sort_natural_char_clean},
+      [TYPE_STRING] = {sort_bubble_str_clean, sort_insertion_str_clean,
+                       sort_shell_str_clean, sort_quick_str_clean, NULL,
+                       sort_par_quick_str_clean, sort_par_merge_str_clean,
+                       multikey_str_clean, sort_natural_str_clean,
+                       prefix_str_clean},
+  };
+  if ((unsigned)t >= TYPE_CUSTOM || (unsigned)algo >= ALGO_COUNT)
+    return NULL;
+  return table[t][algo];
+}
+
+SortKernel get_sort_kernel_traced(DataType t, SortAlgo algo) {
+  static const SortKernel table[TYPE_CUSTOM][ALGO_QUICK + 1] = {
+      [TYPE_INT] = {sort_bubble_int_traced, sort_insertion_int_traced,
+                    sort_shell_int_traced, sort_quick_int_traced},
+      [TYPE_DOUBLE] = {sort_bubble_double_traced, sort_insertion_double_traced,
+                       sort_shell_double_traced, sort_quick_double_traced},
+      [TYPE_CHAR] = {sort_bubble_char_traced, sort_insertion_char_traced,
+                     sort_shell_char_traced, sort_quick_char_traced},
+      [TYPE_STRING] = {sort_bubble_str_traced, sort_insertion_str_traced,
+                       sort_shell_str_traced, sort_quick_str_traced},
+  };
+  if ((unsigned)t >= TYPE_CUSTOM || (unsigned)algo > ALGO_QUICK)
+    return NULL;
+  return table[t][algo];
+}
+
+SelectKernel get_select_kernel(DataType t, SelectOp op) {
+  static const SelectKernel table[TYPE_CUSTOM][SELECT_COUNT] = {
+      [TYPE_INT] = {select_nth_int, partial_sort_int, top_k_int},
+      [TYPE_DOUBLE] = {select_nth_double, partial_sort_double, top_k_double},
+      [TYPE_CHAR] = {select_nth_char, partial_sort_char, top_k_char},
+      [TYPE_STRING] = {select_nth_str, partial_sort_str, top_k_str},
+  };
+  if ((unsigned)t >= TYPE_CUSTOM || (unsigned)op >= SELECT_COUNT)
+    return NULL;
+  return table[t][op];
+}
+
+SelectKernel get_select_kernel_clean(DataType t, SelectOp op) {
+  static const SelectKernel table[TYPE_CUSTOM][SELECT_COUNT] = {
+      [TYPE_INT] = {select_nth_int_clean, partial_sort_int_clean,
+                    top_k_int_clean},
+      [TYPE_DOUBLE] = {select_nth_double_clean, partial_sort_double_clean,
+                       top_k_double_clean},
+      [TYPE_CHAR] = {select_nth_char_clean, partial_sort_char_clean,
+                     top_k_char_clean},
+      [TYPE_STRING] = {select_nth_str_clean, partial_sort_str_clean,
+                       top_k_str_clean},
+  };
+  if ((unsigned)t >= TYPE_CUSTOM || (unsigned)op >= SELECT_COUNT)
+    return NULL;
+  return table[t][op];
+}
@@ -0,0 +1,57 @@
+#include "backend.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Bump allocator for strings: blocks of at least ARENA_BLOCK bytes, each
+// request carved from the newest block. Nothing is freed on its own, the
+// whole arena goes at once.
+
+#define ARENA_BLOCK (64 * 1024)
+
+struct ArenaBlock {
+  struct ArenaBlock *next;
+  size_t used, cap;
+  char data[];
+};
+
+void string_arena_init(StringArena *a) { a->head = NULL; }
+
+char *string_arena_alloc(StringArena *a, size_t bytes) {
+  ArenaBlock *b = a->head;
+  if (!b || b->cap - b->used < bytes) {
+    size_t cap = bytes > ARENA_BLOCK ? bytes : ARENA_BLOCK;
+    b = malloc(sizeof(ArenaBlock) + cap);
+    if (!b)
+      return NULL;
+    b->used = 0;
+    b->cap = cap;
+    // A large request gets its own block behind the current one, so the
+    // space left in the current block stays usable
+    if (a->head && cap > ARENA_BLOCK) {
+      b->next = a->head->next;
+      a->head->next = b;
+    } else {
+      b->next = a->head;
+      a->head = b;
+    }
+  }
+  char *p = b->data + b->used;
+  b->used += bytes;
+  return p;
+}
+
+char *string_arena_dup(StringArena *a, const char *s) {
+  size_t len = strlen(s) + 1;
+  char *p = string_arena_alloc(a, len);
+  if (p)
+    memcpy(p, s, len);
+  return p;
+}
+
+void string_arena_free(StringArena *a) {
+  while (a->head) {
+    ArenaBlock *next = a->head->next;
+    free(a->head);
+    a->head = next;
+  }
+}
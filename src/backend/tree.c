@@ -248,31 +248,42 @@ TreeNode *nary_to_binary(NaryNode *root) {
 static void str_append(char **buf, size_t *cap, size_t *len, void *data,
                        DataType type) {
   char temp[64];
+  const char *text = temp;
+  size_t l;
   switch (type) {
   case TYPE_INT:
-    snprintf(temp, 64, "%d ", *(int *)data);
+    l = fmt_int64(temp, *(int *)data);
     break;
-  case TYPE_DOUBLE:
-    snprintf(temp, 64, "%.2f ", *(double *)data);
+  case TYPE_DOUBLE: {
+    // printf's text as before: labels are not a hot path, and fmt_fixed
+    // would cut large values at 31 characters instead of 63
+    int n = snprintf(temp, sizeof(temp), "%.2f", *(double *)data);
+    l = n < 0 ? 0 : n < (int)sizeof(temp) ? (size_t)n : sizeof(temp) - 1;
     break;
+  }
   case TYPE_CHAR:
-    snprintf(temp, 64, "%c ", *(char *)data);
+    temp[0] = *(char *)data;
+    l = 1;
     break;
   case TYPE_STRING:
-    snprintf(temp, 64, "%s ", (char *)data);
+    text = data;
+    l = strlen(text);
     break;
   default:
-    snprintf(temp, 64, "? ");
+    temp[0] = '?';
+    l = 1;
     break;
   }
 
-  size_t l = strlen(temp);
-  if (*len + l + 1 >= *cap) {
-    *cap = (*cap) * 2 + 64;
+  // Value, then a space
+  if (*len + l + 2 >= *cap) {
+    *cap = (*cap) * 2 + l + 64;
     *buf = realloc(*buf, *cap);
   }
-  strcpy(*buf + *len, temp);
+  memcpy(*buf + *len, text, l);
   *len += l;
+  (*buf)[(*len)++] = ' ';
+  (*buf)[*len] = 0;
 }
 
 static void bst_pre_rec(TreeNode *root, char **buf, size_t *cap, size_t *len,
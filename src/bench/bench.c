@@ -0,0 +1,770 @@
+#include "backend.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Headless benchmark: sweeps algorithms x data types x distributions x sizes
+// through the same kernels as the sort tab and prints one row per run, as
+// CSV or JSON (order statistics over repeated runs, see benchmark.c).
+// Times come from the kernels built without operation counting; one extra
+// run of the counting build supplies comparisons/assignments.
+// With -e, times selection queries (nth element, partial sort, top-k)
+// instead of full sorts.
+// With -x, measures the CSV number text paths instead: formatting and
+// parsing through the C library versus num_format.c, and loading the text
+// back from a file with the streaming reader (csv_stream.c).
+// Built with `make bench`, no GTK needed.
+
+static const char *ALGO_NAMES[ALGO_COUNT] = {
+    [ALGO_BUBBLE] = "bubble",       [ALGO_INSERTION] = "insertion",
+    [ALGO_SHELL] = "shell",         [ALGO_QUICK] = "quick",
+    [ALGO_RADIX] = "radix",         [ALGO_PAR_QUICK] = "par_quick",
+    [ALGO_PAR_MERGE] = "par_merge", [ALGO_MULTIKEY] = "multikey",
+    [ALGO_NATURAL] = "natural",     [ALGO_PREFIX] = "prefix",
+};
+static const char *SELECT_NAMES[SELECT_COUNT] = {
+    [SELECT_NTH] = "nth", [SELECT_PARTIAL] = "partial",
+    [SELECT_TOP_K] = "top_k"};
+static const char *TYPE_NAMES[TYPE_CUSTOM] = {"int", "double", "char",
+                                              "string"};
+
+#define MAX_SIZES 32
+
+typedef struct {
+  int algos[ALGO_COUNT];
+  int types[TYPE_CUSTOM];
+  int dists[DIST_COUNT];
+  size_t sizes[MAX_SIZES];
+  int nsizes;
+  DistParams dist;
+  BenchOptions bench;
+  unsigned seed;
+  int json;
+  int generic;      // Run the CompareFunc kernels (sort_*_gen)
+  int instrumented; // Time the counting build instead of the clean one
+  int hw_counters;  // Hardware counter columns (perf_event_open)
+  int text_io;      // Number formatting/parsing instead of sorting (-x)
+  int selects[SELECT_COUNT]; // Selection queries instead of sorting (-e)
+  int select;
+  size_t k; // Rank for nth, count for partial / top_k; 0 = default
+  size_t max_quad;  // Bubble / insertion skipped above this size
+  FILE *out;
+} BenchConfig;
+
+// --- Comparators for the generic path ---
+
+static int cmp_int(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+static int cmp_char(const void *a, const void *b) {
+  return *(const char *)a - *(const char *)b;
+}
+static int cmp_str(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static CompareFunc comparator(DataType t) {
+  static const CompareFunc cmps[TYPE_CUSTOM] = {cmp_int, cmp_double, cmp_char,
+                                                cmp_str};
+  return cmps[t];
+}
+
+static int is_sorted(const void *arr, size_t n, DataType t) {
+  size_t es = get_element_size(t);
+  CompareFunc cmp = comparator(t);
+  for (size_t i = 1; i < n; i++)
+    if (cmp((const char *)arr + (i - 1) * es, (const char *)arr + i * es) > 0)
+      return 0;
+  return 1;
+}
+
+// Orders doubles by bit pattern, a total order that also places NaNs
+static int cmp_double_bits(const void *a, const void *b) {
+  uint64_t x, y;
+  memcpy(&x, a, sizeof(x));
+  memcpy(&y, b, sizeof(y));
+  return (x > y) - (x < y);
+}
+
+// Checks that arr holds the same multiset as src: sorting must not drop or
+// duplicate values (NaNs included)
+static int is_permutation(const void *arr, const void *src, size_t n,
+                          DataType t) {
+  size_t es = get_element_size(t);
+  CompareFunc cmp = t == TYPE_DOUBLE ? cmp_double_bits : comparator(t);
+  char *a = malloc(n * es + 1), *r = malloc(n * es + 1);
+  int ok = a && r;
+  if (ok) {
+    memcpy(a, arr, n * es);
+    memcpy(r, src, n * es);
+    qsort(a, n, es, cmp);
+    qsort(r, n, es, cmp);
+    for (size_t i = 0; ok && i < n; i++)
+      ok = cmp(a + i * es, r + i * es) == 0;
+  }
+  free(a);
+  free(r);
+  return ok;
+}
+
+// Checks the SelectOp postcondition against a sorted copy of the input
+static int is_selected(const void *arr, const void *src, size_t n, DataType t,
+                       SelectOp op, size_t k) {
+  size_t es = get_element_size(t);
+  CompareFunc cmp = comparator(t);
+  void *ref = malloc(n * es + 1);
+  if (!ref)
+    return 0;
+  memcpy(ref, src, n * es);
+  qsort(ref, n, es, cmp);
+  const char *a = arr, *r = ref;
+  int ok = 1;
+  if (op == SELECT_NTH) {
+    for (size_t i = 0; ok && k < n && i < n; i++) {
+      int c = cmp(a + i * es, a + k * es);
+      ok = i < k ? c <= 0 : i > k ? c >= 0 : cmp(a + k * es, r + k * es) == 0;
+    }
+  } else {
+    size_t m = k < n ? k : n;
+    for (size_t i = 0; ok && i < m; i++) {
+      size_t j = op == SELECT_PARTIAL ? i : n - 1 - i;
+      ok = cmp(a + i * es, r + j * es) == 0;
+    }
+  }
+  free(ref);
+  return ok;
+}
+
+// --- Running ---
+
+// State of one measured configuration, passed to bench_measure
+typedef struct {
+  const BenchConfig *cfg;
+  SortAlgo algo;
+  DataType type;
+  const void *src; // Pristine input
+  void *arr;       // Copy sorted by each run
+  size_t n;
+  int counting;    // Counting build (else counting compiled out)
+  SortStats stats; // Counters of the last counting run
+  int select;      // Run select_op with k instead of algo
+  SelectOp select_op;
+  size_t k;
+} RunContext;
+
+static int supported(const BenchConfig *cfg, SortAlgo a, DataType t) {
+  if (!cfg->generic)
+    return get_sort_kernel(t, a) != NULL;
+  return a == ALGO_BUBBLE || a == ALGO_INSERTION || a == ALGO_SHELL ||
+         a == ALGO_QUICK; // No generic version of the others
+}
+
+static void setup_run(void *p) {
+  RunContext *rc = p;
+  memcpy(rc->arr, rc->src, rc->n * get_element_size(rc->type));
+  rc->stats.comparisons = 0;
+  rc->stats.assignments = 0;
+  rc->stats.avoided = 0;
+}
+
+static void run_select(RunContext *rc) {
+  if (!rc->cfg->generic) {
+    SelectKernel k = rc->counting
+                         ? get_select_kernel(rc->type, rc->select_op)
+                         : get_select_kernel_clean(rc->type, rc->select_op);
+    k(rc->arr, rc->n, rc->k, &rc->stats);
+    return;
+  }
+  size_t es = get_element_size(rc->type);
+  CompareFunc cmp = comparator(rc->type);
+  int c = rc->counting;
+  switch (rc->select_op) {
+  case SELECT_NTH:
+    (c ? select_nth_gen : select_nth_gen_clean)(rc->arr, rc->n, es, rc->k,
+                                                cmp, &rc->stats);
+    break;
+  case SELECT_PARTIAL:
+    (c ? partial_sort_gen : partial_sort_gen_clean)(rc->arr, rc->n, es, rc->k,
+                                                    cmp, &rc->stats);
+    break;
+  default:
+    (c ? top_k_gen : top_k_gen_clean)(rc->arr, rc->n, es, rc->k, cmp,
+                                      &rc->stats);
+    break;
+  }
+}
+
+static void run_once(void *p) {
+  RunContext *rc = p;
+  if (rc->select) {
+    run_select(rc);
+    return;
+  }
+  if (!rc->cfg->generic) {
+    SortKernel k = rc->counting ? get_sort_kernel(rc->type, rc->algo)
+                                : get_sort_kernel_clean(rc->type, rc->algo);
+    k(rc->arr, rc->n, &rc->stats);
+    return;
+  }
+  size_t es = get_element_size(rc->type);
+  CompareFunc cmp = comparator(rc->type);
+  int c = rc->counting;
+  switch (rc->algo) {
+  case ALGO_BUBBLE:
+    (c ? sort_bubble_gen : sort_bubble_gen_clean)(rc->arr, rc->n, es, cmp,
+                                                  &rc->stats);
+    break;
+  case ALGO_INSERTION:
+    (c ? sort_insertion_gen : sort_insertion_gen_clean)(rc->arr, rc->n, es,
+                                                        cmp, &rc->stats);
+    break;
+  case ALGO_SHELL:
+    (c ? sort_shell_gen : sort_shell_gen_clean)(rc->arr, rc->n, es, cmp,
+                                                &rc->stats);
+    break;
+  default:
+    (c ? sort_quick_gen : sort_quick_gen_clean)(rc->arr, rc->n, es, cmp,
+                                                &rc->stats);
+    break;
+  }
+}
+
+// Hardware counter columns (-p), empty / null when not measured
+static void emit_hw(const BenchConfig *cfg, const BenchResult *r) {
+  if (!cfg->hw_counters)
+    return;
+  for (int e = 0; e < HW_COUNT; e++) {
+    int valid = r->hw_mask & (1u << e);
+    if (cfg->json && valid)
+      fprintf(cfg->out, "\"%s\": %.0f, ", hw_counter_name(e), r->hw[e]);
+    else if (cfg->json)
+      fprintf(cfg->out, "\"%s\": null, ", hw_counter_name(e));
+    else if (valid)
+      fprintf(cfg->out, "%.0f,", r->hw[e]);
+    else
+      fprintf(cfg->out, ",");
+  }
+}
+
+// algo is the SortAlgo or, with -e, the SelectOp (k column only then)
+static void emit(const BenchConfig *cfg, int *first, DataType t, int algo,
+                 size_t k, Distribution d, size_t n, const BenchResult *r,
+                 const SortStats *s, int ok) {
+  const char *name = cfg->select ? SELECT_NAMES[algo] : ALGO_NAMES[algo];
+  if (cfg->json) {
+    fprintf(cfg->out,
+            "%s\n  {\"type\": \"%s\", \"algo\": \"%s\", \"generic\": %d, "
+            "\"dist\": \"%s\", \"n\": %zu, ",
+            *first ? "" : ",", TYPE_NAMES[t], name, cfg->generic, dist_name(d),
+            n);
+    if (cfg->select)
+      fprintf(cfg->out, "\"k\": %zu, ", k);
+    fprintf(cfg->out,
+            "\"reps\": %d, \"min_ms\": %.6f, \"median_ms\": %.6f, "
+            "\"p95_ms\": %.6f, \"mean_ms\": %.6f, \"stddev_ms\": %.6f, "
+            "\"comparisons\": %lu, \"assignments\": %lu, ",
+            r->reps, r->min, r->median, r->p95, r->mean, r->stddev,
+            s->comparisons, s->assignments);
+    emit_hw(cfg, r);
+    fprintf(cfg->out, "\"ok\": %s}", ok ? "true" : "false");
+  } else {
+    fprintf(cfg->out, "%s,%s,%d,%s,%zu,", TYPE_NAMES[t], name, cfg->generic,
+            dist_name(d), n);
+    if (cfg->select)
+      fprintf(cfg->out, "%zu,", k);
+    fprintf(cfg->out, "%d,%.6f,%.6f,%.6f,%.6f,%.6f,%lu,%lu,", r->reps, r->min,
+            r->median, r->p95, r->mean, r->stddev, s->comparisons,
+            s->assignments);
+    emit_hw(cfg, r);
+    fprintf(cfg->out, "%d\n", ok);
+  }
+  *first = 0;
+}
+
+static int run_all(const BenchConfig *cfg) {
+  int first = 1, failures = 0;
+  if (cfg->json)
+    fprintf(cfg->out, "[");
+  else {
+    fprintf(cfg->out, "type,algo,generic,dist,n,%sreps,min_ms,median_ms,"
+                      "p95_ms,mean_ms,stddev_ms,comparisons,assignments,",
+            cfg->select ? "k," : "");
+    for (int e = 0; cfg->hw_counters && e < HW_COUNT; e++)
+      fprintf(cfg->out, "%s,", hw_counter_name(e));
+    fprintf(cfg->out, "ok\n");
+  }
+
+  for (int t = 0; t < TYPE_CUSTOM; t++) {
+    if (!cfg->types[t])
+      continue;
+    size_t es = get_element_size(t);
+    for (int d = 0; d < DIST_COUNT; d++) {
+      if (!cfg->dists[d])
+        continue;
+      for (int si = 0; si < cfg->nsizes; si++) {
+        size_t n = cfg->sizes[si];
+        // One input per (type, dist, size), cloned for every run so all
+        // algorithms sort exactly the same data
+        void *src = malloc(n * es + 1);
+        void *arr = malloc(n * es + 1);
+        StringArena strings;
+        string_arena_init(&strings);
+        if (!src || !arr ||
+            generate_distribution(src, n, t, d, &cfg->dist,
+                                  cfg->seed + (unsigned)si, &strings) != 0) {
+          fprintf(stderr, "bench: out of memory for n=%zu\n", n);
+          string_arena_free(&strings);
+          free(src);
+          free(arr);
+          return -1;
+        }
+
+        for (int a = 0; a < ALGO_COUNT; a++) {
+          if (!cfg->algos[a] || !supported(cfg, a, t) || cfg->select)
+            continue;
+          if ((a == ALGO_BUBBLE || a == ALGO_INSERTION) && n > cfg->max_quad)
+            continue;
+          RunContext rc = {cfg, a, t, src, arr, n, cfg->instrumented,
+                           {0, 0, 0}, 0, SELECT_NTH, 0};
+          BenchResult res;
+          if (bench_measure(&cfg->bench, setup_run, run_once, &rc, &res) != 0)
+            continue;
+          int ok = is_sorted(arr, n, t) && is_permutation(arr, src, n, t);
+          if (!rc.counting) {
+            // Operation counts from one run of the counting build
+            rc.counting = 1;
+            setup_run(&rc);
+            run_once(&rc);
+            ok = ok && is_sorted(arr, n, t) && is_permutation(arr, src, n, t);
+          }
+          failures += !ok;
+          emit(cfg, &first, t, a, 0, d, n, &res, &rc.stats, ok);
+          fflush(cfg->out);
+        }
+
+        for (int op = 0; cfg->select && op < SELECT_COUNT; op++) {
+          if (!cfg->selects[op] || n == 0)
+            continue;
+          // Defaults: the median, the 100 smallest / largest
+          size_t k = cfg->k ? cfg->k : op == SELECT_NTH ? n / 2 : 100;
+          if (op == SELECT_NTH && k >= n)
+            k = n - 1;
+          RunContext rc = {cfg, ALGO_QUICK, t, src, arr, n,
+                           cfg->instrumented, {0, 0, 0}, 1, op, k};
+          BenchResult res;
+          if (bench_measure(&cfg->bench, setup_run, run_once, &rc, &res) != 0)
+            continue;
+          int ok = is_selected(arr, src, n, t, op, k);
+          if (!rc.counting) {
+            rc.counting = 1;
+            setup_run(&rc);
+            run_once(&rc);
+            ok = ok && is_selected(arr, src, n, t, op, k);
+          }
+          failures += !ok;
+          emit(cfg, &first, t, op, k, d, n, &res, &rc.stats, ok);
+          fflush(cfg->out);
+        }
+
+        string_arena_free(&strings);
+        free(src);
+        free(arr);
+      }
+    }
+  }
+  if (cfg->json)
+    fprintf(cfg->out, "\n]\n");
+  return failures;
+}
+
+// --- Number text I/O (-x) ---
+
+// One measured (type, operation, implementation): formatting src as
+// comma-separated text, parsing that text back into out, or loading it
+// from `file` (parse == IO_LOAD)
+#define IO_LOAD 2
+
+typedef struct {
+  DataType type;
+  const void *src;
+  size_t n;
+  int parse;
+  int fast; // num_format.c, else snprintf / strtol / strtod
+  char *text;
+  size_t len;
+  void *out;
+  FILE *file;   // The text, for IO_LOAD
+  void *loaded; // Last array read by IO_LOAD (NULL when empty)
+  int load_ok;  // Whether that read succeeded with n elements
+} IoContext;
+
+static void io_run(void *p) {
+  IoContext *io = p;
+  if (io->parse == IO_LOAD) {
+    size_t count;
+    free(io->loaded);
+    rewind(io->file);
+    io->load_ok = csv_read_array(io->file, ",", io->type, NULL, NULL, NULL,
+                                 &io->loaded, &count) == 0 &&
+                  count == io->n;
+    return;
+  }
+  if (!io->parse) {
+    char *t = io->text;
+    for (size_t i = 0; i < io->n; i++) {
+      if (io->type == TYPE_INT) {
+        int v = ((const int *)io->src)[i];
+        t += io->fast ? fmt_int64(t, v) : (size_t)sprintf(t, "%d", v);
+      } else {
+        double v = ((const double *)io->src)[i];
+        t += io->fast ? fmt_double(t, v) : (size_t)sprintf(t, "%.17g", v);
+      }
+      *t++ = ',';
+    }
+    io->len = (size_t)(t - io->text);
+    return;
+  }
+  const char *t = io->text, *end = io->text + io->len;
+  for (size_t i = 0; i < io->n && t < end; i++) {
+    char *stop;
+    if (io->type == TYPE_INT) {
+      int64_t v = 0;
+      if (io->fast) {
+        t = parse_int64(t, end, &v);
+      } else {
+        v = strtol(t, &stop, 10);
+        t = stop;
+      }
+      ((int *)io->out)[i] = (int)v;
+    } else {
+      double v = 0;
+      if (io->fast) {
+        t = parse_double(t, end, &v);
+      } else {
+        v = strtod(t, &stop);
+        t = stop;
+      }
+      ((double *)io->out)[i] = v;
+    }
+    if (!t)
+      return;
+    t++; // ','
+  }
+}
+
+static void emit_io(const BenchConfig *cfg, int *first, const IoContext *io,
+                    Distribution d, const BenchResult *r, int ok) {
+  const char *op = io->parse == IO_LOAD ? "load"
+                   : io->parse           ? "parse"
+                                         : "format";
+  const char *impl = io->parse == IO_LOAD ? "csv_stream"
+                     : io->fast           ? "num_format"
+                                          : "libc";
+  double mbps = r->median > 0 ? io->len / (r->median * 1000.0) : 0;
+  if (cfg->json)
+    fprintf(cfg->out,
+            "%s\n  {\"type\": \"%s\", \"op\": \"%s\", \"impl\": \"%s\", "
+            "\"dist\": \"%s\", \"n\": %zu, \"reps\": %d, \"min_ms\": %.6f, "
+            "\"median_ms\": %.6f, \"p95_ms\": %.6f, \"mb_per_s\": %.1f, "
+            "\"ok\": %s}",
+            *first ? "" : ",", TYPE_NAMES[io->type], op, impl, dist_name(d),
+            io->n, r->reps, r->min, r->median, r->p95, mbps,
+            ok ? "true" : "false");
+  else
+    fprintf(cfg->out, "%s,%s,%s,%s,%zu,%d,%.6f,%.6f,%.6f,%.1f,%d\n",
+            TYPE_NAMES[io->type], op, impl, dist_name(d), io->n, r->reps,
+            r->min, r->median, r->p95, mbps, ok);
+  *first = 0;
+}
+
+// Int and double only: chars and strings are copied, not converted
+static int run_text_io(const BenchConfig *cfg) {
+  int first = 1, failures = 0;
+  if (cfg->json)
+    fprintf(cfg->out, "[");
+  else
+    fprintf(cfg->out, "type,op,impl,dist,n,reps,min_ms,median_ms,p95_ms,"
+                      "mb_per_s,ok\n");
+  for (int t = TYPE_INT; t <= TYPE_DOUBLE; t++) {
+    if (!cfg->types[t])
+      continue;
+    size_t es = get_element_size(t);
+    for (int d = 0; d < DIST_COUNT; d++) {
+      if (!cfg->dists[d])
+        continue;
+      for (int si = 0; si < cfg->nsizes; si++) {
+        size_t n = cfg->sizes[si];
+        void *src = malloc(n * es + 1);
+        void *out = malloc(n * es + 1);
+        char *text = malloc(n * 32 + 1); // 24 bytes per %.17g at most
+        if (!src || !out || !text ||
+            generate_distribution(src, n, t, d, &cfg->dist,
+                                  cfg->seed + (unsigned)si, NULL) != 0) {
+          fprintf(stderr, "bench: out of memory for n=%zu\n", n);
+          free(src);
+          free(out);
+          free(text);
+          return -1;
+        }
+        for (int parse = 0; parse < 2; parse++)
+          for (int fast = 0; fast < 2; fast++) {
+            IoContext io = {t, src, n, 0, 1, text, 0, out, NULL, NULL, 0};
+            io_run(&io); // Parsers all read the num_format text
+            io.parse = parse;
+            io.fast = fast;
+            memset(out, 0, n * es);
+            BenchResult res;
+            if (bench_measure(&cfg->bench, NULL, io_run, &io, &res) != 0)
+              continue;
+            if (!parse) { // Check the text by reading it back
+              io.parse = 1;
+              io.fast = 1;
+              io_run(&io);
+              io.parse = 0;
+              io.fast = fast;
+            }
+            int ok = memcmp(out, src, n * es) == 0;
+            failures += !ok;
+            emit_io(cfg, &first, &io, d, &res, ok);
+            fflush(cfg->out);
+          }
+        // Streaming load of the same text from a file (the page cache once
+        // warm, so this is parse throughput at memory bandwidth)
+        IoContext io = {t, src, n, 0, 1, text, 0, out, tmpfile(), NULL, 0};
+        io_run(&io);
+        if (io.file && fwrite(text, 1, io.len, io.file) == io.len) {
+          io.parse = IO_LOAD;
+          BenchResult res;
+          if (bench_measure(&cfg->bench, NULL, io_run, &io, &res) == 0) {
+            int ok = io.load_ok &&
+                     (n == 0 || memcmp(io.loaded, src, n * es) == 0);
+            failures += !ok;
+            emit_io(cfg, &first, &io, d, &res, ok);
+            fflush(cfg->out);
+          }
+        }
+        free(io.loaded);
+        if (io.file)
+          fclose(io.file);
+        free(src);
+        free(out);
+        free(text);
+      }
+    }
+  }
+  if (cfg->json)
+    fprintf(cfg->out, "\n]\n");
+  return failures;
+}
+
+// --- Command line ---
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: sorter_bench [options]\n"
+          "  -a LIST   algorithms: bubble,insertion,shell,quick,radix,\n"
+          "            par_quick,par_merge,multikey,natural,prefix or all "
+          "(default all)\n"
+          "  -t LIST   types: int,double,char,string or all (default int)\n"
+          "  -d LIST   distributions: random,sorted,reversed,few_unique,\n"
+          "            organ_pipe,sawtooth,nearly_sorted,zipf,all_equal,\n"
+          "            sorted_runs or all (default random)\n"
+          "  -n LIST   sizes (default 1000,10000,100000)\n"
+          "  -u N      distinct values for few_unique, ranks for zipf "
+          "(default 16)\n"
+          "  -k N      random swaps for nearly_sorted (default 10)\n"
+          "  -l N      run length for sawtooth and sorted_runs (default 64)\n"
+          "  -z S      zipf exponent (default 1.0)\n"
+          "  -w N      warmup runs per configuration (default 1)\n"
+          "  -m N      minimum timed runs (default 3)\n"
+          "  -r N      maximum timed runs (default 15)\n"
+          "  -b MS     time budget per configuration, in ms (default 250)\n"
+          "  -s N      random seed (default 42)\n"
+          "  -j N      threads for the parallel sorts (default: all cores)\n"
+          "  -c N      sequential cutoff for the parallel sorts\n"
+          "  -q N      skip bubble/insertion above N elements "
+          "(default 20000)\n"
+          "  -g        use the generic CompareFunc kernels\n"
+          "  -i        time the counting build (default: counting compiled "
+          "out)\n"
+          "  -p        add hardware counters (cycles, instructions, L1d/LLC "
+          "misses,\n"
+          "            branch misses; Linux perf_event_open, empty if "
+          "unavailable)\n"
+          "  -e LIST   selection queries instead of sorting: nth,partial,\n"
+          "            top_k or all\n"
+          "  -K N      rank for nth (default n/2, the median), count for\n"
+          "            partial and top_k (default 100)\n"
+          "  -x        measure number formatting/parsing (libc vs "
+          "num_format)\n"
+          "            and streaming CSV loads for the int and double types\n"
+          "            instead of sorting\n"
+          "  -f FMT    csv or json (default csv)\n"
+          "  -o FILE   output file (default stdout)\n");
+}
+
+// Sets flags[i] for each comma-separated name of names[0..count)
+static int parse_names(char *list, const char **names, int count, int *flags) {
+  memset(flags, 0, count * sizeof(int));
+  for (char *p = strtok(list, ","); p; p = strtok(NULL, ",")) {
+    int found = 0;
+    for (int i = 0; i < count; i++)
+      if (!strcmp(p, "all") || !strcmp(p, names[i])) {
+        flags[i] = 1;
+        found = 1;
+      }
+    if (!found) {
+      fprintf(stderr, "bench: unknown name '%s'\n", p);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  BenchConfig cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  for (int a = 0; a < ALGO_COUNT; a++)
+    cfg.algos[a] = 1;
+  cfg.types[TYPE_INT] = 1;
+  cfg.dists[DIST_RANDOM] = 1;
+  cfg.sizes[0] = 1000;
+  cfg.sizes[1] = 10000;
+  cfg.sizes[2] = 100000;
+  cfg.nsizes = 3;
+  dist_default_params(&cfg.dist);
+  bench_default_options(&cfg.bench);
+  cfg.seed = 42;
+  cfg.max_quad = 20000;
+  cfg.out = stdout;
+  int threads = 0;
+  long cutoff = 0;
+  const char *dist_names[DIST_COUNT];
+  for (int d = 0; d < DIST_COUNT; d++)
+    dist_names[d] = dist_name(d);
+
+  for (int i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+    if (!strcmp(opt, "-g")) {
+      cfg.generic = 1;
+      continue;
+    }
+    if (!strcmp(opt, "-i")) {
+      cfg.instrumented = 1;
+      continue;
+    }
+    if (!strcmp(opt, "-x")) {
+      cfg.text_io = 1;
+      continue;
+    }
+    if (!strcmp(opt, "-p")) {
+      cfg.hw_counters = 1;
+      cfg.bench.hw_counters = 1;
+      continue;
+    }
+    if (!strcmp(opt, "-h") || opt[0] != '-' || i + 1 >= argc) {
+      usage();
+      return opt[0] == '-' && opt[1] == 'h' ? 0 : 2;
+    }
+    char *val = argv[++i];
+    int rc = 0;
+    switch (opt[1]) {
+    case 'a':
+      rc = parse_names(val, ALGO_NAMES, ALGO_COUNT, cfg.algos);
+      break;
+    case 'e':
+      rc = parse_names(val, SELECT_NAMES, SELECT_COUNT, cfg.selects);
+      cfg.select = 1;
+      break;
+    case 'K':
+      cfg.k = strtoul(val, NULL, 10);
+      break;
+    case 't':
+      rc = parse_names(val, TYPE_NAMES, TYPE_CUSTOM, cfg.types);
+      break;
+    case 'd':
+      rc = parse_names(val, dist_names, DIST_COUNT, cfg.dists);
+      break;
+    case 'n':
+      cfg.nsizes = 0;
+      for (char *p = strtok(val, ","); p && cfg.nsizes < MAX_SIZES;
+           p = strtok(NULL, ","))
+        cfg.sizes[cfg.nsizes++] = strtoul(p, NULL, 10);
+      break;
+    case 'u':
+      cfg.dist.unique = strtoul(val, NULL, 10);
+      break;
+    case 'k':
+      cfg.dist.swaps = strtoul(val, NULL, 10);
+      break;
+    case 'l':
+      cfg.dist.run_length = strtoul(val, NULL, 10);
+      break;
+    case 'z':
+      cfg.dist.zipf_s = atof(val);
+      break;
+    case 'w':
+      cfg.bench.warmup = atoi(val);
+      break;
+    case 'm':
+      cfg.bench.min_reps = atoi(val);
+      break;
+    case 'r':
+      cfg.bench.max_reps = atoi(val);
+      break;
+    case 'b':
+      cfg.bench.budget_ms = atof(val);
+      break;
+    case 's':
+      cfg.seed = (unsigned)strtoul(val, NULL, 10);
+      break;
+    case 'j':
+      threads = atoi(val);
+      break;
+    case 'c':
+      cutoff = atol(val);
+      break;
+    case 'q':
+      cfg.max_quad = strtoul(val, NULL, 10);
+      break;
+    case 'f':
+      cfg.json = !strcmp(val, "json");
+      rc = cfg.json || !strcmp(val, "csv") ? 0 : -1;
+      break;
+    case 'o':
+      cfg.out = fopen(val, "w");
+      rc = cfg.out ? 0 : -1;
+      break;
+    default:
+      rc = -1;
+    }
+    if (rc != 0) {
+      usage();
+      return 2;
+    }
+  }
+
+  sort_parallel_config(threads, cutoff > 0 ? (size_t)cutoff : 16384);
+  if (cfg.hw_counters) {
+    HwCounters hc;
+    if (hw_counters_open(&hc) != 0)
+      fprintf(stderr, "bench: hardware counters unavailable, columns left "
+                      "empty\n");
+    else
+      hw_counters_close(&hc);
+  }
+  int failures = cfg.text_io ? run_text_io(&cfg) : run_all(&cfg);
+  if (cfg.out != stdout)
+    fclose(cfg.out);
+  if (failures > 0)
+    fprintf(stderr, "bench: %d %s\n", failures,
+            cfg.text_io  ? "round trip(s) failed"
+            : cfg.select ? "wrong selection(s)"
+                         : "unsorted result(s)");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+#include "gui.h"
+#include <gtk/gtk.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Virtual list of an array: a drawing area plus a scrollbar whose
+// adjustment counts rows. Only the rows on screen are formatted, at draw
+// time, so scrolling through 100M elements costs the same as through 100.
+// The array is borrowed, never copied.
+
+#define ROW_HEIGHT 18
+#define INDEX_WIDTH 90 // Index column, in pixels
+
+struct DataView {
+  GtkWidget *box;
+  GtkWidget *label_msg;
+  GtkWidget *label_count;
+  GtkWidget *entry_goto;
+  GtkWidget *area;
+  GtkAdjustment *adj; // First visible row, page = visible rows
+  const void *arr;
+  size_t n;
+  DataType type;
+  size_t hl_lo, hl_hi; // Highlighted rows [hl_lo, hl_hi)
+};
+
+// Text of element i, NUL-terminated in buf (at least 64 bytes)
+static const char *format_element(const DataView *v, size_t i, char *buf) {
+  switch (v->type) {
+  case TYPE_INT:
+    fmt_int64(buf, ((const int *)v->arr)[i]);
+    return buf;
+  case TYPE_DOUBLE:
+    fmt_fixed(buf, ((const double *)v->arr)[i], 2);
+    return buf;
+  case TYPE_CHAR:
+    buf[0] = '\'';
+    buf[1] = ((const char *)v->arr)[i];
+    buf[2] = '\'';
+    buf[3] = 0;
+    return buf;
+  case TYPE_STRING: {
+    // At most 60 bytes, the area clips the rest anyway. The cut falls on
+    // a character boundary, before any invalid byte: cairo stops drawing
+    // on the whole context after one invalid string.
+    const char *s = ((char *const *)v->arr)[i];
+    const char *valid;
+    g_utf8_validate(s, (gssize)strnlen(s, 60), &valid);
+    size_t len = (size_t)(valid - s);
+    buf[0] = '"';
+    memcpy(buf + 1, s, len);
+    buf[len + 1] = '"';
+    buf[len + 2] = 0;
+    return buf;
+  }
+  default:
+    return "?";
+  }
+}
+
+static void update_adjustment(DataView *v) {
+  int h = gtk_widget_get_allocated_height(v->area);
+  double rows = h > ROW_HEIGHT ? (double)(h / ROW_HEIGHT) : 1;
+  gtk_adjustment_configure(v->adj, gtk_adjustment_get_value(v->adj), 0,
+                           (double)v->n, 1, rows, rows);
+}
+
+static void on_size_allocate(GtkWidget *w, GdkRectangle *alloc,
+                             gpointer data) {
+  update_adjustment(data);
+}
+
+static void on_value_changed(GtkAdjustment *adj, gpointer data) {
+  DataView *v = data;
+  gtk_widget_queue_draw(v->area);
+}
+
+static gboolean on_scroll(GtkWidget *w, GdkEventScroll *e, gpointer data) {
+  DataView *v = data;
+  double step = 3, value = gtk_adjustment_get_value(v->adj);
+  if (e->direction == GDK_SCROLL_UP)
+    value -= step;
+  else if (e->direction == GDK_SCROLL_DOWN)
+    value += step;
+  else if (e->direction == GDK_SCROLL_SMOOTH)
+    value += e->delta_y * step;
+  gtk_adjustment_set_value(v->adj, value); // Clamped to the last page
+  return TRUE;
+}
+
+static gboolean on_draw(GtkWidget *w, cairo_t *cr, gpointer data) {
+  DataView *v = data;
+  double width = gtk_widget_get_allocated_width(w);
+  int h = gtk_widget_get_allocated_height(w);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_paint(cr);
+  if (!v->arr || v->n == 0)
+    return FALSE;
+
+  cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL,
+                         CAIRO_FONT_WEIGHT_NORMAL);
+  cairo_set_font_size(cr, 12);
+  size_t first = (size_t)gtk_adjustment_get_value(v->adj);
+  char buf[64];
+  for (int row = 0; row * ROW_HEIGHT < h && first + row < v->n; row++) {
+    size_t i = first + row;
+    double y = row * ROW_HEIGHT;
+    if (i >= v->hl_lo && i < v->hl_hi) {
+      cairo_set_source_rgb(cr, 1.0, 0.93, 0.6);
+      cairo_rectangle(cr, 0, y, width, ROW_HEIGHT);
+      cairo_fill(cr);
+    }
+    fmt_int64(buf, (int64_t)i);
+    cairo_set_source_rgb(cr, 0.55, 0.55, 0.55);
+    cairo_move_to(cr, 5, y + ROW_HEIGHT - 5);
+    cairo_show_text(cr, buf);
+    cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+    cairo_move_to(cr, INDEX_WIDTH, y + ROW_HEIGHT - 5);
+    cairo_show_text(cr, format_element(v, i, buf));
+  }
+  return FALSE;
+}
+
+// "i" jumps to element i, "a-b" also highlights a..b
+static void on_goto(GtkEntry *entry, gpointer data) {
+  DataView *v = data;
+  const char *text = gtk_entry_get_text(entry);
+  char *end;
+  size_t a = strtoull(text, &end, 10), b = a;
+  if (end == text || v->n == 0)
+    return;
+  while (*end == ' ')
+    end++;
+  if (*end == '-')
+    b = strtoull(end + 1, NULL, 10);
+  if (b < a) {
+    size_t t = a;
+    a = b;
+    b = t;
+  }
+  if (a >= v->n)
+    return;
+  data_view_highlight(v, a, b + 1);
+  data_view_scroll_to(v, a);
+}
+
+static void on_destroy(GtkWidget *w, gpointer data) { free(data); }
+
+DataView *data_view_new(void) {
+  DataView *v = calloc(1, sizeof(DataView));
+  if (!v)
+    return NULL;
+  v->type = TYPE_INT;
+
+  v->box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+  g_signal_connect(v->box, "destroy", G_CALLBACK(on_destroy), v);
+
+  v->label_msg = gtk_label_new("");
+  gtk_label_set_xalign(GTK_LABEL(v->label_msg), 0);
+  gtk_label_set_line_wrap(GTK_LABEL(v->label_msg), TRUE);
+  gtk_widget_set_no_show_all(v->label_msg, TRUE);
+  gtk_box_pack_start(GTK_BOX(v->box), v->label_msg, FALSE, FALSE, 0);
+
+  GtkWidget *box_nav = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  v->entry_goto = gtk_entry_new();
+  gtk_entry_set_placeholder_text(GTK_ENTRY(v->entry_goto),
+                                 "Aller à (i ou a-b)");
+  g_signal_connect(v->entry_goto, "activate", G_CALLBACK(on_goto), v);
+  v->label_count = gtk_label_new("0 éléments");
+  gtk_box_pack_start(GTK_BOX(box_nav), v->entry_goto, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_nav), v->label_count, FALSE, FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(v->box), box_nav, FALSE, FALSE, 0);
+
+  GtkWidget *box_list = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+  v->adj = gtk_adjustment_new(0, 0, 0, 1, 1, 1);
+  g_signal_connect(v->adj, "value-changed", G_CALLBACK(on_value_changed), v);
+  v->area = gtk_drawing_area_new();
+  gtk_widget_add_events(v->area, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+  g_signal_connect(v->area, "draw", G_CALLBACK(on_draw), v);
+  g_signal_connect(v->area, "scroll-event", G_CALLBACK(on_scroll), v);
+  g_signal_connect(v->area, "size-allocate", G_CALLBACK(on_size_allocate), v);
+  gtk_box_pack_start(GTK_BOX(box_list), v->area, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_list),
+                     gtk_scrollbar_new(GTK_ORIENTATION_VERTICAL, v->adj),
+                     FALSE, FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(v->box), box_list, TRUE, TRUE, 0);
+  return v;
+}
+
+GtkWidget *data_view_widget(DataView *v) { return v->box; }
+
+void data_view_set_data(DataView *v, const void *arr, size_t n, DataType t) {
+  v->arr = arr;
+  v->n = arr ? n : 0;
+  v->type = t;
+  v->hl_lo = v->hl_hi = 0;
+  data_view_set_message(v, NULL);
+
+  char count[32];
+  fmt_int64(count, (int64_t)v->n);
+  char *text = g_strdup_printf("%s éléments", count);
+  gtk_label_set_text(GTK_LABEL(v->label_count), text);
+  g_free(text);
+
+  gtk_adjustment_set_value(v->adj, 0);
+  update_adjustment(v);
+  gtk_widget_queue_draw(v->area);
+}
+
+void data_view_set_message(DataView *v, const char *msg) {
+  gtk_label_set_text(GTK_LABEL(v->label_msg), msg ? msg : "");
+  gtk_widget_set_visible(v->label_msg, msg != NULL);
+}
+
+void data_view_scroll_to(DataView *v, size_t index) {
+  gtk_adjustment_set_value(v->adj, (double)index);
+}
+
+void data_view_highlight(DataView *v, size_t lo, size_t hi) {
+  v->hl_lo = lo;
+  v->hl_hi = hi > lo ? hi : lo;
+  gtk_widget_queue_draw(v->area);
+}
@@ -26,3 +26,76 @@ void load_css(void) {
 
   g_object_unref(provider);
 }
+
+// --- Benchmark chart metrics ---
+
+static const char *METRIC_LABELS[METRIC_COUNT] = {
+    [METRIC_TIME] = "Temps médian (ms)",
+    [METRIC_CYCLES] = "Cycles",
+    [METRIC_INSTRUCTIONS] = "Instructions",
+    [METRIC_IPC] = "Instructions par cycle",
+    [METRIC_L1D_MISSES] = "Défauts de cache L1d",
+    [METRIC_LLC_MISSES] = "Défauts de cache LLC",
+    [METRIC_BRANCH_MISSES] = "Erreurs de prédiction",
+};
+
+GtkWidget *chart_metric_combo(void) {
+  GtkWidget *combo = gtk_combo_box_text_new();
+  for (int m = 0; m < METRIC_COUNT; m++)
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo),
+                                   METRIC_LABELS[m]);
+  gtk_combo_box_set_active(GTK_COMBO_BOX(combo), METRIC_TIME);
+  return combo;
+}
+
+const char *chart_metric_label(ChartMetric m) {
+  return (unsigned)m < METRIC_COUNT ? METRIC_LABELS[m] : "";
+}
+
+static int hw_value(const BenchResult *r, HwCounter c, double *out) {
+  if (!(r->hw_mask & (1u << c)))
+    return -1;
+  *out = r->hw[c];
+  return 0;
+}
+
+int chart_metric_value(const BenchResult *r, ChartMetric m, double *out) {
+  double instr, cycles;
+  switch (m) {
+  case METRIC_TIME:
+    *out = r->median;
+    return r->reps > 0 ? 0 : -1;
+  case METRIC_CYCLES:
+    return hw_value(r, HW_CYCLES, out);
+  case METRIC_INSTRUCTIONS:
+    return hw_value(r, HW_INSTRUCTIONS, out);
+  case METRIC_IPC:
+    if (hw_value(r, HW_INSTRUCTIONS, &instr) ||
+        hw_value(r, HW_CYCLES, &cycles) || cycles == 0)
+      return -1;
+    *out = instr / cycles;
+    return 0;
+  case METRIC_L1D_MISSES:
+    return hw_value(r, HW_L1D_MISSES, out);
+  case METRIC_LLC_MISSES:
+    return hw_value(r, HW_LLC_MISSES, out);
+  case METRIC_BRANCH_MISSES:
+    return hw_value(r, HW_BRANCH_MISSES, out);
+  default:
+    return -1;
+  }
+}
+
+// Axis labels: counts are shortened (12.5M), IPC keeps two decimals
+void chart_format_value(char *buf, size_t size, double v, ChartMetric m) {
+  if (m == METRIC_IPC)
+    snprintf(buf, size, "%.2f", v);
+  else if (m == METRIC_TIME || v < 1e3)
+    snprintf(buf, size, "%.0f", v);
+  else if (v < 1e6)
+    snprintf(buf, size, "%.1fk", v / 1e3);
+  else if (v < 1e9)
+    snprintf(buf, size, "%.1fM", v / 1e6);
+  else
+    snprintf(buf, size, "%.1fG", v / 1e9);
+}
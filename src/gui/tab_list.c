@@ -34,6 +34,16 @@ typedef struct {
   // View Toggle
   gboolean show_chart;
   GtkWidget *btn_toggle_view;
+  GtkWidget *combo_metric; // Chart Y axis (ChartMetric)
+
+  // Background comparison (see list_compare_thread)
+  GtkWidget *btn_compare;
+  GtkWidget *btn_cancel_cmp;
+  GtkWidget *progress_cmp;
+  GCancellable *compare_cancel;
+  void *compare_job; // ListCompareJob running, NULL when idle
+  guint compare_generation;
+  guint load_generation; // Of the latest load, see list_load_thread
 } TabListWidgets;
 
 static TabListWidgets *widgets_list;
@@ -208,8 +218,14 @@ static gboolean on_draw_list(GtkWidget *widget, cairo_t *cr, gpointer data) {
 
 // --- Logic ---
 
-static void on_clear(GtkWidget *b, gpointer d) {
+// Empties the list; a load still running is dropped when it finishes
+static void clear_list(void) {
+  widgets_list->load_generation++;
   list_clear(&widgets_list->list);
+}
+
+static void on_clear(GtkWidget *b, gpointer d) {
+  clear_list();
   gtk_widget_queue_draw(widgets_list->drawing_area);
   update_stats();
 }
@@ -221,7 +237,7 @@ static void on_config_change(GtkWidget *w, gpointer d) {
       GTK_TOGGLE_BUTTON(widgets_list->radio_double));
 
   if (widgets_list->list.type != dtype || widgets_list->list.is_doubly != dbl) {
-    list_clear(&widgets_list->list);
+    clear_list();
     list_init(&widgets_list->list, dtype, dbl);
     gtk_widget_queue_draw(widgets_list->drawing_area);
     update_stats();
@@ -291,7 +307,7 @@ static void on_add_tail(GtkWidget *b, gpointer d) { parse_and_add(1); }
 static void on_insert_at(GtkWidget *b, gpointer d) { parse_and_add(2); }
 
 static void on_gen_rand(GtkWidget *b, gpointer d) {
-  list_clear(&widgets_list->list);
+  clear_list();
   int n = atoi(gtk_entry_get_text(GTK_ENTRY(widgets_list->entry_rand_n)));
   if (n <= 0)
     n = 5;
@@ -410,7 +426,8 @@ static void on_sort_quick(GtkWidget *b, gpointer d) {
 static int LIST_BENCH_SIZES[MAX_POINTS];
 
 typedef struct {
-  double times[MAX_POINTS];
+  BenchResult results[MAX_POINTS]; // Median plotted, min..p95 as error bar
+  int nb_points;                   // Points measured so far
   GdkRGBA color;
   const char *name;
   int marker_type;
@@ -425,6 +442,8 @@ static int has_ll_bench_data = 0;
 // --- Chart Drawing Logic ---
 
 static void draw_chart_popup(cairo_t *cr, double w, double h) {
+  ChartMetric metric =
+      gtk_combo_box_get_active(GTK_COMBO_BOX(widgets_list->combo_metric));
   double margin = 50.0;
   double graph_w = w - 2 * margin;
   double graph_h = h - 2 * margin;
@@ -465,7 +484,7 @@ static void draw_chart_popup(cairo_t *cr, double w, double h) {
   cairo_translate(cr, 15, h / 2);
   cairo_rotate(cr, -G_PI / 2);
   cairo_set_font_size(cr, 12);
-  cairo_show_text(cr, "Temps (ms)");
+  cairo_show_text(cr, chart_metric_label(metric));
   cairo_restore(cr);
 
   // X Axis Labels
@@ -482,23 +501,41 @@ static void draw_chart_popup(cairo_t *cr, double w, double h) {
   if (!has_ll_bench_data)
     return;
 
-  double max_time = 0;
+  double max_val = 0, v;
+  int nb_values = 0;
   AlgoBenchmark *benches[] = {&bench_ll_bulle, &bench_ll_insert,
                               &bench_ll_shell, &bench_ll_quick};
 
   for (int b = 0; b < 4; b++)
-    for (int i = 0; i < MAX_POINTS; i++)
-      if (benches[b]->times[i] > max_time)
-        max_time = benches[b]->times[i];
+    for (int i = 0; i < benches[b]->nb_points; i++) {
+      const BenchResult *r = &benches[b]->results[i];
+      if (chart_metric_value(r, metric, &v) != 0)
+        continue;
+      nb_values++;
+      if (metric == METRIC_TIME)
+        v = r->p95; // Room for the error bars
+      if (v > max_val)
+        max_val = v;
+    }
 
-  if (max_time == 0)
-    max_time = 1;
+  if (max_val == 0)
+    max_val = 1;
+
+  if (metric != METRIC_TIME && nb_values == 0) {
+    const char *msg = "Compteurs matériels indisponibles sur ce système";
+    cairo_set_source_rgb(cr, 0.5, 0.5, 0.5);
+    cairo_set_font_size(cr, 12);
+    cairo_text_extents(cr, msg, &ext);
+    cairo_move_to(cr, w / 2 - ext.width / 2, h / 2);
+    cairo_show_text(cr, msg);
+    return;
+  }
 
   // Y Axis Labels
   for (int i = 0; i <= 5; i++) {
-    double val = max_time * (1.0 - i / 5.0);
+    double val = max_val * (1.0 - i / 5.0);
     char buf[32];
-    snprintf(buf, 32, "%.0f", val);
+    chart_format_value(buf, sizeof(buf), val, metric);
     cairo_text_extents(cr, buf, &ext);
     cairo_move_to(cr, margin - ext.width - 5,
                   margin + i * (graph_h / 5) + ext.height / 2);
@@ -509,22 +546,36 @@ static void draw_chart_popup(cairo_t *cr, double w, double h) {
   for (int b = 0; b < 4; b++) {
     gdk_cairo_set_source_rgba(cr, &benches[b]->color);
     cairo_set_line_width(cr, 2.0);
-    for (int i = 0; i < MAX_POINTS; i++) {
+    cairo_new_path(cr);
+    for (int i = 0; i < benches[b]->nb_points; i++) {
+      if (chart_metric_value(&benches[b]->results[i], metric, &v) != 0)
+        continue;
       double x = margin + (i * (graph_w / (MAX_POINTS - 1)));
-      double y =
-          (margin + graph_h) - (benches[b]->times[i] / max_time * graph_h);
-      if (i == 0)
-        cairo_move_to(cr, x, y);
-      else
-        cairo_line_to(cr, x, y);
+      double y = (margin + graph_h) - (v / max_val * graph_h);
+      cairo_line_to(cr, x, y); // Moves to the first point
     }
     cairo_stroke(cr);
 
-    // Draw Markers
-    for (int i = 0; i < MAX_POINTS; i++) {
+    // Draw Markers, with a min..p95 error bar
+    for (int i = 0; i < benches[b]->nb_points; i++) {
+      const BenchResult *r = &benches[b]->results[i];
+      if (chart_metric_value(r, metric, &v) != 0)
+        continue;
       double x = margin + (i * (graph_w / (MAX_POINTS - 1)));
-      double y =
-          (margin + graph_h) - (benches[b]->times[i] / max_time * graph_h);
+      double y = (margin + graph_h) - (v / max_val * graph_h);
+      double y_lo = (margin + graph_h) - (r->min / max_val * graph_h);
+      double y_hi = (margin + graph_h) - (r->p95 / max_val * graph_h);
+      if (metric == METRIC_TIME && y_lo - y_hi > 1.0) {
+        cairo_set_line_width(cr, 1.0);
+        cairo_move_to(cr, x, y_lo);
+        cairo_line_to(cr, x, y_hi);
+        cairo_move_to(cr, x - 3, y_lo);
+        cairo_line_to(cr, x + 3, y_lo);
+        cairo_move_to(cr, x - 3, y_hi);
+        cairo_line_to(cr, x + 3, y_hi);
+        cairo_stroke(cr);
+        cairo_set_line_width(cr, 2.0);
+      }
 
       cairo_new_path(cr);
       if (benches[b]->marker_type == 0) // Circle
@@ -597,29 +648,199 @@ static gboolean on_draw_popup(GtkWidget *widget, cairo_t *cr, gpointer data) {
   return FALSE;
 }
 
-static void perform_benchmarks() {
-  srand(time(NULL));
+// One (algorithm, size) point: before each timed run the list is relinked
+// in input order over a node pool allocated once per comparison, so no
+// malloc/free lands between the runs; only list_sort is measured
+typedef struct {
+  LinkedList list;
+  Node *pool;
+  DataType type;
+  const void *values; // Input of this size, shared by every algorithm
+  int n;
+  int algo;
+  CompareFunc cmp;
+} ListBenchRun;
+
+static void list_bench_setup(void *p) {
+  ListBenchRun *run = p;
+  list_init_pooled(&run->list, run->type, 0, run->pool, run->values, run->n);
+}
+
+static void list_bench_run(void *p) {
+  ListBenchRun *run = p;
+  list_sort(&run->list, run->algo, run->cmp);
+}
+
+// --- Background comparison ---
+// Same scheme as the sort tab: a GTask worker measures the points and sends
+// each one to the main loop with g_idle_add; Annuler stops at the next run.
+
+typedef struct {
+  DataType type;
+  CompareFunc cmp;
+  int sizes[MAX_POINTS];
+  guint generation;
+  atomic_int cancel; // Set by the GUI thread, read between runs
+} ListCompareJob;
+
+typedef struct {
+  guint generation;
+  int algo, point;
+  int done;
+  BenchResult result;
+} ListComparePoint;
+
+static AlgoBenchmark *list_benches[] = {&bench_ll_bulle, &bench_ll_insert,
+                                        &bench_ll_shell, &bench_ll_quick};
+
+static gboolean on_list_compare_point(gpointer data) {
+  ListComparePoint *pt = data;
+  // Late update from a previous (cancelled) comparison
+  if (pt->generation == widgets_list->compare_generation) {
+    AlgoBenchmark *bench = list_benches[pt->algo];
+    bench->results[pt->point] = pt->result;
+    bench->nb_points = pt->point + 1;
+    if (widgets_list->compare_job) {
+      char text[64];
+      snprintf(text, sizeof(text), "N = %d : %d / %d",
+               LIST_BENCH_SIZES[pt->point], pt->done, 4 * MAX_POINTS);
+      gtk_progress_bar_set_fraction(
+          GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+          (double)pt->done / (4 * MAX_POINTS));
+      gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                                text);
+    }
+    gtk_widget_queue_draw(widgets_list->drawing_area);
+  }
+  g_free(pt);
+  return G_SOURCE_REMOVE;
+}
+
+static void list_compare_thread(GTask *task, gpointer source,
+                                gpointer task_data, GCancellable *cancellable) {
+  ListCompareJob *job = task_data;
   FILE *log = fopen("bench_log.txt", "w");
   if (log)
     fprintf(log, "Starting Benchmark\n");
 
+  BenchOptions opt;
+  bench_default_options(&opt);
+  opt.cancel = &job->cancel;
+  opt.hw_counters = 1; // Chart Y axis choices, left empty when unavailable
+  DistParams params;
+  dist_default_params(&params);
+  params.range = 10000; // Integers in 0..9999
+  unsigned seed = g_random_int();
+
+  // Sizes grow, the last one sizes the pool
+  Node *pool = malloc(job->sizes[MAX_POINTS - 1] * sizeof(Node));
+  size_t es = get_element_size(job->type);
+  int done = 0;
+  for (int i = 0; pool && i < MAX_POINTS && !atomic_load(&job->cancel); i++) {
+    int n = job->sizes[i];
+
+    // Generated once per size: all four algorithms sort the same values
+    StringArena strings;
+    string_arena_init(&strings);
+    void *values = malloc(n * es);
+    if (!values || generate_distribution(values, n, job->type, DIST_RANDOM,
+                                         &params, seed + i, &strings) != 0) {
+      free(values);
+      string_arena_free(&strings);
+      continue;
+    }
+
+    // Benchmark Loop
+    for (int b = 0; b < 4 && !atomic_load(&job->cancel); b++) {
+      ListBenchRun run = {.pool = pool, .type = job->type, .values = values,
+                          .n = n, .algo = b, .cmp = job->cmp};
+
+      ListComparePoint *pt = g_new0(ListComparePoint, 1);
+      pt->generation = job->generation;
+      pt->algo = b;
+      pt->point = i;
+      BenchResult *r = &pt->result;
+      if (bench_measure(&opt, list_bench_setup, list_bench_run, &run, r) != 0)
+        memset(r, 0, sizeof(*r));
+
+      if (atomic_load(&job->cancel)) {
+        g_free(pt); // Interrupted point: not plotted
+        break;
+      }
+      if (log) {
+        fprintf(log,
+                "Size: %d, Algo: %d, Runs: %d, Min: %.3f ms, Median: %.3f ms, "
+                "P95: %.3f ms, Stddev: %.3f ms",
+                n, b, r->reps, r->min, r->median, r->p95, r->stddev);
+        for (int e = 0; e < HW_COUNT; e++)
+          if (r->hw_mask & (1u << e))
+            fprintf(log, ", %s: %.0f", hw_counter_name(e), r->hw[e]);
+        fprintf(log, "\n");
+      }
+      pt->done = ++done;
+      g_idle_add(on_list_compare_point, pt);
+    }
+
+    string_arena_free(&strings);
+    free(values);
+  }
+  free(pool);
+  if (log) {
+    if (atomic_load(&job->cancel))
+      fprintf(log, "Cancelled\n");
+    fclose(log);
+  }
+  g_task_return_boolean(task, !atomic_load(&job->cancel));
+}
+
+static void on_list_compare_done(GObject *source, GAsyncResult *res,
+                                 gpointer data) {
+  ListCompareJob *job = g_task_get_task_data(G_TASK(res));
+  gboolean finished = g_task_propagate_boolean(G_TASK(res), NULL);
+  if (job == widgets_list->compare_job) {
+    widgets_list->compare_job = NULL;
+    gtk_widget_set_sensitive(widgets_list->btn_compare, TRUE);
+    gtk_widget_set_sensitive(widgets_list->btn_cancel_cmp, FALSE);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                              finished ? "Comparaison terminée"
+                                       : "Comparaison annulée");
+    if (finished)
+      gtk_progress_bar_set_fraction(
+          GTK_PROGRESS_BAR(widgets_list->progress_cmp), 1.0);
+  }
+}
+
+static void on_cancel_compare(GtkWidget *b, gpointer d) {
+  ListCompareJob *job = widgets_list->compare_job;
+  if (!job)
+    return;
+  atomic_store(&job->cancel, 1);
+  g_cancellable_cancel(widgets_list->compare_cancel);
+  gtk_widget_set_sensitive(widgets_list->btn_cancel_cmp, FALSE);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                            "Annulation...");
+}
+
+static void perform_benchmarks() {
   // Dynamic Size Calculation
   const char *s_n = gtk_entry_get_text(GTK_ENTRY(widgets_list->entry_rand_n));
   int max_n = atoi(s_n);
   if (max_n <= 0)
     max_n = 1000;
 
+  ListCompareJob *job = g_new0(ListCompareJob, 1);
+  job->type = widgets_list->list.type;
+  job->cmp = get_cmp_func();
+  job->generation = ++widgets_list->compare_generation;
+
   // Create 5 steps
   for (int i = 0; i < MAX_POINTS; i++) {
     LIST_BENCH_SIZES[i] = (max_n * (i + 1)) / MAX_POINTS;
     if (LIST_BENCH_SIZES[i] == 0)
       LIST_BENCH_SIZES[i] = 1;
+    job->sizes[i] = LIST_BENCH_SIZES[i];
   }
 
-  // Generate data and run sorts
-  AlgoBenchmark *benches[] = {&bench_ll_bulle, &bench_ll_insert,
-                              &bench_ll_shell, &bench_ll_quick};
-
   // Init colors if not done
   if (bench_ll_bulle.name == NULL) {
     bench_ll_bulle.name = "Bulle";
@@ -638,63 +859,26 @@ static void perform_benchmarks() {
     bench_ll_quick.marker_type = 3;
     gdk_rgba_parse(&bench_ll_quick.color, "#5CB85C");
   }
-
-  DataType type = widgets_list->list.type;
-  CompareFunc cmp = get_cmp_func();
-
-  for (int i = 0; i < MAX_POINTS; i++) {
-    int n = LIST_BENCH_SIZES[i];
-
-    int *rand_ints = NULL;
-    double *rand_doubles = NULL;
-
-    if (type == TYPE_INT) {
-      rand_ints = malloc(n * sizeof(int));
-      for (int k = 0; k < n; k++)
-        rand_ints[k] = rand() % 10000;
-    } else if (type == TYPE_DOUBLE) {
-      rand_doubles = malloc(n * sizeof(double));
-      for (int k = 0; k < n; k++)
-        rand_doubles[k] = (double)rand() / RAND_MAX * 1000.0;
-    }
-
-    // Benchmark Loop
-    for (int b = 0; b < 4; b++) {
-      LinkedList temp_list;
-      list_init(&temp_list, type, 0);
-
-      // Build list
-      for (int k = 0; k < n; k++) {
-        if (type == TYPE_INT)
-          list_append(&temp_list, &rand_ints[k]);
-        else if (type == TYPE_DOUBLE)
-          list_append(&temp_list, &rand_doubles[k]);
-        else {
-          int v = rand();
-          list_append(&temp_list, &v);
-        }
-      }
-
-      clock_t start = clock();
-      list_sort(&temp_list, b, cmp);
-      clock_t end = clock();
-
-      benches[b]->times[i] = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
-      if (log)
-        fprintf(log, "Size: %d, Algo: %d, Time: %.2f ms\n", n, b,
-                benches[b]->times[i]);
-
-      list_clear(&temp_list);
-    }
-
-    if (rand_ints)
-      free(rand_ints);
-    if (rand_doubles)
-      free(rand_doubles);
-  }
-  if (log)
-    fclose(log);
+  for (int b = 0; b < 4; b++)
+    list_benches[b]->nb_points = 0;
   has_ll_bench_data = 1;
+
+  if (widgets_list->compare_cancel)
+    g_object_unref(widgets_list->compare_cancel);
+  widgets_list->compare_cancel = g_cancellable_new();
+  widgets_list->compare_job = job;
+  gtk_widget_set_sensitive(widgets_list->btn_compare, FALSE);
+  gtk_widget_set_sensitive(widgets_list->btn_cancel_cmp, TRUE);
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                                0.0);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                            "Comparaison en cours...");
+
+  GTask *task = g_task_new(NULL, widgets_list->compare_cancel,
+                           on_list_compare_done, NULL);
+  g_task_set_task_data(task, job, g_free);
+  g_task_run_in_thread(task, list_compare_thread);
+  g_object_unref(task);
 }
 
 static void on_toggle_view(GtkWidget *b, gpointer d) {
@@ -712,7 +896,14 @@ static void on_toggle_view(GtkWidget *b, gpointer d) {
   gtk_widget_queue_draw(widgets_list->drawing_area);
 }
 
+static void on_metric_changed(GtkComboBox *combo, gpointer data) {
+  if (widgets_list->show_chart)
+    gtk_widget_queue_draw(widgets_list->drawing_area);
+}
+
 static void on_compare_all(GtkWidget *b, gpointer d) {
+  if (widgets_list->compare_job)
+    return; // Already running
   perform_benchmarks();
   widgets_list->show_chart = TRUE;
   gtk_button_set_label(GTK_BUTTON(widgets_list->btn_toggle_view), "Voir Liste");
@@ -741,26 +932,45 @@ static void on_save_list(GtkWidget *btn, gpointer data) {
       fprintf(f, "%d,%d\n", widgets_list->list.type,
               widgets_list->list.is_doubly);
 
+      // Values formatted into a buffer written in large blocks; doubles in
+      // their shortest exact form
+      char out[65536];
+      size_t used = 0, room = sizeof(out) - 64; // 64: one number + ','
       Node *curr = widgets_list->list.head;
       while (curr) {
+        if (used > room) {
+          fwrite(out, 1, used, f);
+          used = 0;
+        }
         switch (widgets_list->list.type) {
         case TYPE_INT:
-          fprintf(f, "%d", *(int *)curr->data);
+          used += fmt_int64(out + used, *(int *)curr->data);
           break;
         case TYPE_DOUBLE:
-          fprintf(f, "%.4f", *(double *)curr->data);
+          used += fmt_double(out + used, *(double *)curr->data);
           break;
         case TYPE_CHAR:
-          fprintf(f, "%c", *(char *)curr->data);
-          break;
-        case TYPE_STRING:
-          fprintf(f, "%s", (char *)curr->data);
+          out[used++] = *(char *)curr->data;
           break;
+        case TYPE_STRING: {
+          size_t len = strlen(curr->data);
+          if (len > room - used) {
+            fwrite(out, 1, used, f);
+            used = 0;
+          }
+          if (len > room) {
+            fwrite(curr->data, 1, len, f);
+          } else {
+            memcpy(out + used, curr->data, len);
+            used += len;
+          }
+        } break;
         }
         if (curr->next)
-          fprintf(f, ",");
+          out[used++] = ',';
         curr = curr->next;
       }
+      fwrite(out, 1, used, f);
       fclose(f);
     }
     g_free(filename);
@@ -768,84 +978,146 @@ static void on_save_list(GtkWidget *btn, gpointer data) {
   gtk_widget_destroy(dialog);
 }
 
+// Loads run on a worker thread into a list private to the ListLoadJob,
+// which on_list_load_done swaps in on the GUI thread. Clearing, generating
+// or retyping the list meanwhile bumps load_generation, and the finished
+// load is dropped.
+typedef struct {
+  char *filename;
+  guint generation;
+  LinkedList list;
+} ListLoadJob;
+
+typedef struct {
+  guint generation;
+  double fraction;
+} ListLoadProgress;
+
+static void list_load_job_free(gpointer data) {
+  ListLoadJob *job = data;
+  list_clear(&job->list);
+  g_free(job->filename);
+  g_free(job);
+}
+
+// Comma-separated field of a loaded file, appended to the job's list
+static int append_loaded(char *p, size_t len, void *user) {
+  LinkedList *list = user;
+  void *val = NULL;
+  int64_t ival = 0;
+  int i32;
+  double dval = 0;
+  char cval;
+  switch (list->type) {
+  case TYPE_INT:
+    parse_int64(p, p + len, &ival); // Unparsable fields give 0
+    i32 = (int)ival;
+    val = &i32;
+    break;
+  case TYPE_DOUBLE:
+    parse_double(p, p + len, &dval);
+    val = &dval;
+    break;
+  case TYPE_CHAR:
+    cval = p[0];
+    val = &cval;
+    break;
+  case TYPE_STRING:
+    val = p; // NUL-terminated in place
+    break;
+  default:
+    return -1;
+  }
+  list_append(list, val);
+  return 0;
+}
+
+static gboolean on_load_progress(gpointer data) {
+  ListLoadProgress *lp = data;
+  if (lp->generation == widgets_list->load_generation) {
+    gtk_progress_bar_set_fraction(
+        GTK_PROGRESS_BAR(widgets_list->progress_cmp), lp->fraction);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                              "Chargement...");
+  }
+  g_free(lp);
+  return G_SOURCE_REMOVE;
+}
+
+// Called by csv_read_fields on the worker thread
+static void post_load_progress(double fraction, void *user) {
+  ListLoadJob *job = user;
+  ListLoadProgress *lp = g_new(ListLoadProgress, 1);
+  lp->generation = job->generation;
+  lp->fraction = fraction;
+  g_idle_add(on_load_progress, lp);
+}
+
+static void list_load_thread(GTask *task, gpointer source, gpointer task_data,
+                             GCancellable *cancellable) {
+  ListLoadJob *job = task_data;
+  FILE *f = fopen(job->filename, "r");
+  int type_int, is_doubly;
+  // Read Header
+  gboolean ok = f && fscanf(f, "%d,%d\n", &type_int, &is_doubly) == 2 &&
+                type_int >= TYPE_INT && type_int < TYPE_CUSTOM;
+  if (ok) {
+    list_init(&job->list, (DataType)type_int, is_doubly);
+    // Read Content, streamed block by block
+    ok = csv_read_fields(f, ",", append_loaded, &job->list,
+                         post_load_progress, job) == 0;
+  }
+  if (f)
+    fclose(f);
+  g_task_return_boolean(task, ok);
+}
+
+static void on_list_load_done(GObject *source, GAsyncResult *res,
+                              gpointer data) {
+  ListLoadJob *job = g_task_get_task_data(G_TASK(res));
+  gboolean ok = g_task_propagate_boolean(G_TASK(res), NULL);
+  if (job->generation != widgets_list->load_generation)
+    return; // Superseded, list_load_job_free drops it
+  if (!ok) {
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                              "Lecture du fichier impossible");
+    return;
+  }
+  // Update UI to match loaded config (on_config_change empties the list)
+  gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_list->combo_data_type),
+                           job->list.type);
+  if (job->list.is_doubly)
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widgets_list->radio_double),
+                                 TRUE);
+  else
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widgets_list->radio_simple),
+                                 TRUE);
+  // The job hands its nodes over to the tab
+  clear_list();
+  widgets_list->list = job->list;
+  list_init(&job->list, job->list.type, job->list.is_doubly);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                            "Chargement terminé");
+  gtk_widget_queue_draw(widgets_list->drawing_area);
+  update_stats();
+}
+
 static void on_load_list(GtkWidget *btn, gpointer data) {
   GtkWidget *dialog = gtk_file_chooser_dialog_new(
       "Charger Liste", NULL, GTK_FILE_CHOOSER_ACTION_OPEN, "Annuler",
       GTK_RESPONSE_CANCEL, "Ouvrir", GTK_RESPONSE_ACCEPT, NULL);
 
   if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
-    char *filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
-    FILE *f = fopen(filename, "r");
-    if (f) {
-      int type_int, is_doubly;
-      // Read Header
-      if (fscanf(f, "%d,%d\n", &type_int, &is_doubly) == 2) {
-        list_clear(&widgets_list->list);
-        list_init(&widgets_list->list, (DataType)type_int, is_doubly);
-
-        // Update UI to match loaded config
-        gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_list->combo_data_type),
-                                 type_int);
-        if (is_doubly)
-          gtk_toggle_button_set_active(
-              GTK_TOGGLE_BUTTON(widgets_list->radio_double), TRUE);
-        else
-          gtk_toggle_button_set_active(
-              GTK_TOGGLE_BUTTON(widgets_list->radio_simple), TRUE);
-
-        // Read Content
-        fseek(f, 0, SEEK_END);
-        long fsize = ftell(f);
-        fseek(f, 0, SEEK_SET);
-
-        // Skip header line... rough approximation or just read line
-        char line[256];
-        fgets(line, sizeof(line), f);
-
-        long data_pos = ftell(f);
-        long data_len = fsize - data_pos;
-
-        if (data_len > 0) {
-          char *buf = malloc(data_len + 1);
-          fread(buf, 1, data_len, f);
-          buf[data_len] = 0;
-
-          char *dup = strdup(buf);
-          char *p = strtok(dup, ",");
-          while (p) {
-            void *val = NULL;
-            int ival;
-            double dval;
-            char cval;
-            switch (widgets_list->list.type) {
-            case TYPE_INT:
-              ival = atoi(p);
-              val = &ival;
-              break;
-            case TYPE_DOUBLE:
-              dval = atof(p);
-              val = &dval;
-              break;
-            case TYPE_CHAR:
-              cval = p[0];
-              val = &cval;
-              break;
-            case TYPE_STRING:
-              val = p;
-              break;
-            }
-            list_append(&widgets_list->list, val);
-            p = strtok(NULL, ",");
-          }
-          free(dup);
-          free(buf);
-        }
-      }
-      fclose(f);
-      gtk_widget_queue_draw(widgets_list->drawing_area);
-      update_stats();
-    }
-    g_free(filename);
+    ListLoadJob *job = g_new0(ListLoadJob, 1);
+    job->filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+    list_init(&job->list, TYPE_INT, 0);
+    job->generation = ++widgets_list->load_generation;
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                                  0);
+    GTask *task = g_task_new(NULL, NULL, on_list_load_done, NULL);
+    g_task_set_task_data(task, job, list_load_job_free);
+    g_task_run_in_thread(task, list_load_thread);
+    g_object_unref(task);
   }
   gtk_widget_destroy(dialog);
 }
@@ -858,6 +1130,10 @@ GtkWidget *create_tab_list(void) {
 
   widgets_list = malloc(sizeof(TabListWidgets));
   list_init(&widgets_list->list, TYPE_INT, 0);
+  widgets_list->compare_cancel = NULL;
+  widgets_list->compare_job = NULL;
+  widgets_list->compare_generation = 0;
+  widgets_list->load_generation = 0;
 
   GtkWidget *paned = gtk_paned_new(GTK_ORIENTATION_HORIZONTAL);
   gtk_paned_set_position(GTK_PANED(paned), 350);
@@ -1029,10 +1305,24 @@ GtkWidget *create_tab_list(void) {
   gtk_grid_attach(GTK_GRID(grid_sort), bs4, 1, 1, 1, 1);
   gtk_box_pack_start(GTK_BOX(box_ops), grid_sort, FALSE, FALSE, 5);
 
+  GtkWidget *box_cmp = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
   GtkWidget *btn_cmp = gtk_button_new_with_label("Comparer Tout");
   style_button_color(btn_cmp, "#28A745");
   g_signal_connect(btn_cmp, "clicked", G_CALLBACK(on_compare_all), NULL);
-  gtk_box_pack_start(GTK_BOX(box_ops), btn_cmp, FALSE, FALSE, 0);
+  GtkWidget *btn_cancel = gtk_button_new_with_label("Annuler");
+  style_button_color(btn_cancel, "#D9534F");
+  g_signal_connect(btn_cancel, "clicked", G_CALLBACK(on_cancel_compare), NULL);
+  gtk_widget_set_sensitive(btn_cancel, FALSE);
+  gtk_box_pack_start(GTK_BOX(box_cmp), btn_cmp, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_cmp), btn_cancel, FALSE, FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_ops), box_cmp, FALSE, FALSE, 0);
+  widgets_list->btn_compare = btn_cmp;
+  widgets_list->btn_cancel_cmp = btn_cancel;
+  widgets_list->progress_cmp = gtk_progress_bar_new();
+  gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(widgets_list->progress_cmp),
+                                 TRUE);
+  gtk_box_pack_start(GTK_BOX(box_ops), widgets_list->progress_cmp, FALSE, FALSE,
+                     0);
 
   widgets_list->show_chart = FALSE; // Default List View
 
@@ -1043,6 +1333,16 @@ GtkWidget *create_tab_list(void) {
   gtk_box_pack_start(GTK_BOX(box_ops), widgets_list->btn_toggle_view, FALSE,
                      FALSE, 5);
 
+  GtkWidget *box_metric = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  widgets_list->combo_metric = chart_metric_combo();
+  g_signal_connect(widgets_list->combo_metric, "changed",
+                   G_CALLBACK(on_metric_changed), NULL);
+  gtk_box_pack_start(GTK_BOX(box_metric), gtk_label_new("Axe Y :"), FALSE,
+                     FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_metric), widgets_list->combo_metric, TRUE,
+                     TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_ops), box_metric, FALSE, FALSE, 0);
+
   GtkWidget *btn_reset = gtk_button_new_with_label("Tout Recommencer");
   style_button_color(btn_reset, "#DC3545");
   g_signal_connect(btn_reset, "clicked", G_CALLBACK(on_clear), NULL);
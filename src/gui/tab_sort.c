@@ -1,7 +1,9 @@
 #include "backend.h"
 #include "gui.h"
 #include <ctype.h>
+#include <errno.h>
 #include <gtk/gtk.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,6 +12,8 @@
 // --- Data Structures ---
 
 #define MAX_POINTS 5
+#define NB_ALGOS ALGO_COUNT // Series of the chart, indexed by SortAlgo
+#define GEN_MAX_SIZE 1000000000 // Elements generated at most
 static int BENCH_SIZES[MAX_POINTS];
 
 // ... (typedefs)
@@ -18,10 +22,14 @@ static int BENCH_SIZES[MAX_POINTS];
 // Now in backend.h
 
 typedef struct {
-  double times[MAX_POINTS];
+  BenchResult results[MAX_POINTS]; // Median plotted, min..p95 as error bar
+  int nb_points;                   // Points measured so far
   GdkRGBA color;
   const char *name;
-  int marker_type; // 0=Circle, 1=Square, 2=Triangle, 3=Diamond
+  int marker_type; // 0=Circle, 1=Square, 2=Triangle, 3=Diamond, 4=Cross,
+                   // 5=Inverted triangle, 6=Ring, 7=Plus, 8=Hollow square,
+                   // 9=Hollow diamond
+  int active;      // 0 when the algorithm does not apply to the data type
 } AlgoBenchmark;
 
 typedef struct {
@@ -29,6 +37,8 @@ typedef struct {
   void *array;
   size_t size;
   DataType current_type;
+  StringArena strings; // Storage of the TYPE_STRING elements of array
+  ArrayFile mapped;    // array is mapped.array when loaded from a .bin
 
   // UI Elements
   GtkWidget *entry_size;
@@ -36,31 +46,67 @@ typedef struct {
   GtkWidget *radio_auto;
   GtkWidget *radio_manual;
 
+  // Input distribution (Auto mode and comparisons)
+  GtkWidget *combo_dist;
+  GtkWidget *entry_dist_param; // Meaning depends on the distribution
+
   // New Manual Input UI
   GtkWidget *entry_manual_val; // For single value input
   GtkWidget *box_manual_input;
 
-  // Text Views for Data
-  GtkWidget *text_raw;
-  GtkWidget *text_sorted;
+  // Data views: the input, and the result of the last sort
+  DataView *view_raw;
+  DataView *view_sorted;
+  void *sorted; // Shown by view_sorted, strings still in `strings`
+
+  // Selection queries: rank or count
+  GtkWidget *entry_k;
+
+  // Parallel sort tuning
+  GtkWidget *entry_threads;
+  GtkWidget *entry_cutoff;
+
+  // External (file to file) sort
+  GtkWidget *entry_ext_mem;
+  GtkWidget *progress_ext;
 
   // Chart
   GtkWidget *drawing_area;
+  GtkWidget *combo_metric; // Y axis (ChartMetric)
 
   // Benchmark Data
-  AlgoBenchmark bench_bulle;
-  AlgoBenchmark bench_insertion;
-  AlgoBenchmark bench_shell;
-  AlgoBenchmark bench_quick;
+  AlgoBenchmark benches[NB_ALGOS];
   int has_bench_data;
 
+  // Background comparison (see compare_thread)
+  GtkWidget *btn_compare;
+  GtkWidget *btn_cancel_cmp;
+  GtkWidget *progress_cmp;
+  GCancellable *compare_cancel;
+  void *compare_job; // CompareJob of the running comparison, NULL when idle
+  guint compare_generation;
+  guint load_generation; // Of the latest CSV load, see load_thread
+
+  // Replay of the last traced run (see record_trace)
+  GtkWidget *check_trace;
+  GtkWidget *area_replay;
+  GtkWidget *btn_play;
+  GtkWidget *scale_pos;   // Event position, seek and scrub
+  GtkWidget *scale_speed; // log10 of the events per frame
+  GtkWidget *label_replay;
+  SortTrace trace;
+  SortReplay replay;
+  double *trace_values; // Bar height of each input element
+  double trace_min, trace_max;
+  int has_trace;
+  guint replay_timer;    // 0 when paused
+  int replay_updating;   // Set while the timer moves scale_pos
+
 } TabSortWidgets;
 
 static TabSortWidgets *widgets_sort;
 
-// --- Generic Sorting Utils (UNCHANGED) ---
-
-typedef int (*CompareFunc)(const void *, const void *);
+// --- Comparators (generic path, see sort_generic.c) ---
 
 int cmp_int(const void *a, const void *b) { return (*(int *)a - *(int *)b); }
 int cmp_double(const void *a, const void *b) {
@@ -71,105 +117,6 @@ int cmp_str(const void *a, const void *b) {
   return strcmp(*(char **)a, *(char **)b);
 }
 
-static void swap_gen(void *a, void *b, size_t size) {
-  char temp[size];
-  memcpy(temp, a, size);
-  memcpy(a, b, size);
-  memcpy(b, temp, size);
-}
-
-// 1. Bubble Sort
-void sort_bubble_gen(void *base, size_t n, size_t size, CompareFunc cmp,
-                     SortStats *stats) {
-  if (n < 2)
-    return;
-  char *arr = (char *)base;
-  for (size_t i = 0; i < n - 1; i++) {
-    for (size_t j = 0; j < n - i - 1; j++) {
-      stats->comparisons++;
-      if (cmp(arr + j * size, arr + (j + 1) * size) > 0) {
-        swap_gen(arr + j * size, arr + (j + 1) * size, size);
-        stats->assignments += 3;
-      }
-    }
-  }
-}
-
-// 2. Insertion Sort
-void sort_insertion_gen(void *base, size_t n, size_t size, CompareFunc cmp,
-                        SortStats *stats) {
-  char *arr = (char *)base;
-  char key[size];
-  for (size_t i = 1; i < n; i++) {
-    memcpy(key, arr + i * size, size);
-    long j = i - 1;
-    while (j >= 0) {
-      stats->comparisons++;
-      if (cmp(arr + j * size, key) > 0) {
-        memcpy(arr + (j + 1) * size, arr + j * size, size);
-        stats->assignments++;
-        j--;
-      } else {
-        break;
-      }
-    }
-    memcpy(arr + (j + 1) * size, key, size);
-    stats->assignments++;
-  }
-}
-
-// 3. Shell Sort
-void sort_shell_gen(void *base, size_t n, size_t size, CompareFunc cmp,
-                    SortStats *stats) {
-  char *arr = (char *)base;
-  for (size_t gap = n / 2; gap > 0; gap /= 2) {
-    for (size_t i = gap; i < n; i++) {
-      char temp[size];
-      memcpy(temp, arr + i * size, size);
-      size_t j;
-      for (j = i; j >= gap; j -= gap) {
-        stats->comparisons++;
-        if (cmp(arr + (j - gap) * size, temp) > 0) {
-          memcpy(arr + j * size, arr + (j - gap) * size, size);
-          stats->assignments++;
-        } else
-          break;
-      }
-      memcpy(arr + j * size, temp, size);
-    }
-  }
-}
-
-// 4. Quick Sort
-void qs_rec(char *arr, long low, long high, size_t size, CompareFunc cmp,
-            SortStats *stats) {
-  if (low < high) {
-    char pivot[size];
-    memcpy(pivot, arr + high * size, size);
-    long i = low - 1;
-    for (long j = low; j < high; j++) {
-      stats->comparisons++;
-      if (cmp(arr + j * size, pivot) < 0) {
-        i++;
-        swap_gen(arr + i * size, arr + j * size, size);
-        stats->assignments += 3;
-      }
-    }
-    swap_gen(arr + (i + 1) * size, arr + high * size, size);
-    stats->assignments += 3;
-
-    long pi = i + 1;
-    qs_rec(arr, low, pi - 1, size, cmp, stats);
-    qs_rec(arr, pi + 1, high, size, cmp, stats);
-  }
-}
-void sort_quick_gen(void *base, size_t n, size_t size, CompareFunc cmp,
-                    SortStats *stats) {
-  if (n < 2)
-    return;
-  qs_rec((char *)base, 0, n - 1, size, cmp, stats);
-}
-
 // --- Helpers ---
 
 static void style_button(GtkWidget *btn, const char *color_str) {
@@ -189,82 +136,311 @@ static GtkWidget *create_card(const char *title) {
   return frame;
 }
 
-static size_t get_element_size(DataType t) {
+static CompareFunc get_comparator(DataType t) {
   switch (t) {
   case TYPE_INT:
-    return sizeof(int);
+    return cmp_int;
   case TYPE_DOUBLE:
-    return sizeof(double);
+    return cmp_double;
   case TYPE_CHAR:
-    return sizeof(char);
+    return cmp_char;
   case TYPE_STRING:
-    return sizeof(char *);
+    return cmp_str;
   }
-  return 0;
+  return NULL;
 }
 
-static CompareFunc get_comparator(DataType t) {
+// Typed kernel when the backend has one, generic CompareFunc path otherwise
+// (TYPE_CUSTOM). `counting` selects the build that fills stats; timing runs
+// use the one with counting compiled out.
+static void run_sort(int id, void *arr, size_t n, DataType t, int counting,
+                     SortStats *stats) {
+  SortKernel kernel =
+      counting ? get_sort_kernel(t, id) : get_sort_kernel_clean(t, id);
+  if (kernel) {
+    kernel(arr, n, stats);
+    return;
+  }
+  size_t es = get_element_size(t);
+  CompareFunc cmp = get_comparator(t);
+  switch (id) {
+  case ALGO_BUBBLE:
+    (counting ? sort_bubble_gen : sort_bubble_gen_clean)(arr, n, es, cmp,
+                                                         stats);
+    break;
+  case ALGO_INSERTION:
+    (counting ? sort_insertion_gen : sort_insertion_gen_clean)(arr, n, es, cmp,
+                                                               stats);
+    break;
+  case ALGO_SHELL:
+    (counting ? sort_shell_gen : sort_shell_gen_clean)(arr, n, es, cmp, stats);
+    break;
+  case ALGO_QUICK:
+  case ALGO_PAR_QUICK:
+  case ALGO_PAR_MERGE:
+  case ALGO_NATURAL:
+    (counting ? sort_quick_gen : sort_quick_gen_clean)(arr, n, es, cmp, stats);
+    break;
+  }
+}
+
+// Threads / sequential cutoff for the parallel sorts (empty = defaults)
+static void apply_parallel_config() {
+  int threads =
+      atoi(gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_threads)));
+  int cutoff = atoi(gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_cutoff)));
+  sort_parallel_config(threads, cutoff > 0 ? (size_t)cutoff : 16384);
+}
+
+// --- Trace Replay ---
+// Bubble, insertion, shell and quick runs can be recorded as a trace (see
+// sort_trace.c) and replayed as bars at any speed, forward or backward,
+// without sorting again. Only the last TRACE_RING events are kept.
+
+#define TRACE_RING (1u << 23) // 64 MB of events
+#define REPLAY_FRAME_MS 33
+
+static void replay_set_playing(int playing) {
+  if (!playing && widgets_sort->replay_timer) {
+    g_source_remove(widgets_sort->replay_timer);
+    widgets_sort->replay_timer = 0;
+  }
+  gtk_button_set_label(GTK_BUTTON(widgets_sort->btn_play),
+                       playing ? "Pause" : "Lecture");
+}
+
+static void replay_clear(void) {
+  replay_set_playing(0);
+  if (widgets_sort->has_trace) {
+    sort_replay_free(&widgets_sort->replay);
+    sort_trace_free(&widgets_sort->trace);
+    free(widgets_sort->trace_values);
+    widgets_sort->trace_values = NULL;
+    widgets_sort->has_trace = 0;
+  }
+  gtk_label_set_text(GTK_LABEL(widgets_sort->label_replay), "Aucune trace");
+  gtk_widget_queue_draw(widgets_sort->area_replay);
+}
+
+// Position label and slider after a seek
+static void replay_show_position(void) {
+  SortReplay *r = &widgets_sort->replay;
+  uint64_t first = sort_trace_first(r->trace);
+  char msg[128];
+  snprintf(msg, sizeof(msg), "Événement %llu / %llu%s",
+           (unsigned long long)r->pos, (unsigned long long)r->trace->total,
+           first > 0 ? " (fin de la trace)" : "");
+  gtk_label_set_text(GTK_LABEL(widgets_sort->label_replay), msg);
+  widgets_sort->replay_updating = 1;
+  gtk_range_set_value(GTK_RANGE(widgets_sort->scale_pos), (double)r->pos);
+  widgets_sort->replay_updating = 0;
+  gtk_widget_queue_draw(widgets_sort->area_replay);
+}
+
+// Height of element i; strings by their first 4 bytes
+static double trace_value(const void *arr, size_t i, DataType t) {
   switch (t) {
   case TYPE_INT:
-    return cmp_int;
+    return ((const int *)arr)[i];
   case TYPE_DOUBLE:
-    return cmp_double;
+    return ((const double *)arr)[i];
   case TYPE_CHAR:
-    return cmp_char;
-  case TYPE_STRING:
-    return cmp_str;
+    return ((const char *)arr)[i];
+  default: {
+    const unsigned char *s = ((unsigned char *const *)arr)[i];
+    double v = 0;
+    for (int k = 0; k < 4; k++) {
+      v = v * 256 + *s;
+      if (*s)
+        s++;
+    }
+    return v;
+  }
   }
-  return NULL;
 }
 
-static void free_data() {
-  if (!widgets_sort->array)
+// Sorts copy (a copy of the data) with the traced kernel and rewinds the
+// replay to the first recorded event. Returns -1, with nothing sorted,
+// when the algorithm has no traced kernel or the trace does not fit.
+static int record_trace(int id, void *copy, SortStats *stats) {
+  DataType t = widgets_sort->current_type;
+  size_t n = widgets_sort->size;
+  replay_clear();
+  if (!get_sort_kernel_traced(t, id))
+    return -1;
+  double *values = malloc(n * sizeof(double));
+  if (!values || sort_trace_init(&widgets_sort->trace, n, TRACE_RING) != 0) {
+    free(values);
+    gtk_label_set_text(GTK_LABEL(widgets_sort->label_replay),
+                       "Trace impossible : mémoire insuffisante");
+    return -1;
+  }
+  widgets_sort->trace_min = widgets_sort->trace_max = trace_value(copy, 0, t);
+  for (size_t i = 0; i < n; i++) {
+    values[i] = trace_value(copy, i, t);
+    if (values[i] < widgets_sort->trace_min)
+      widgets_sort->trace_min = values[i];
+    if (values[i] > widgets_sort->trace_max)
+      widgets_sort->trace_max = values[i];
+  }
+  sort_traced(&widgets_sort->trace, copy, n, t, id, stats);
+  if (sort_replay_init(&widgets_sort->replay, &widgets_sort->trace) != 0) {
+    // The run itself succeeded, only its replay is lost
+    free(values);
+    sort_trace_free(&widgets_sort->trace);
+    gtk_label_set_text(GTK_LABEL(widgets_sort->label_replay),
+                       "Trace impossible : mémoire insuffisante");
+    return 0;
+  }
+  widgets_sort->trace_values = values;
+  widgets_sort->has_trace = 1;
+
+  uint64_t first = sort_trace_first(&widgets_sort->trace);
+  uint64_t total = widgets_sort->trace.total;
+  widgets_sort->replay_updating = 1;
+  gtk_range_set_range(GTK_RANGE(widgets_sort->scale_pos), (double)first,
+                      (double)(total > first ? total : first + 1));
+  widgets_sort->replay_updating = 0;
+  replay_show_position();
+  return 0;
+}
+
+static gboolean on_replay_tick(gpointer data) {
+  SortReplay *r = &widgets_sort->replay;
+  double speed =
+      pow(10, gtk_range_get_value(GTK_RANGE(widgets_sort->scale_speed)));
+  sort_replay_seek(r, r->pos + (uint64_t)speed);
+  replay_show_position();
+  if (r->pos < r->trace->total)
+    return G_SOURCE_CONTINUE;
+  widgets_sort->replay_timer = 0;
+  replay_set_playing(0);
+  return G_SOURCE_REMOVE;
+}
+
+static void on_replay_play(GtkWidget *btn, gpointer data) {
+  if (!widgets_sort->has_trace)
+    return;
+  if (widgets_sort->replay_timer) {
+    replay_set_playing(0);
     return;
-  if (widgets_sort->current_type == TYPE_STRING) {
-    char **strs = (char **)widgets_sort->array;
-    for (size_t i = 0; i < widgets_sort->size; i++)
-      if (strs[i])
-        free(strs[i]);
   }
-  free(widgets_sort->array);
-  widgets_sort->array = NULL;
-  widgets_sort->size = 0;
+  SortReplay *r = &widgets_sort->replay;
+  if (r->pos >= r->trace->total) // Replay from the start
+    sort_replay_seek(r, sort_trace_first(r->trace));
+  widgets_sort->replay_timer =
+      g_timeout_add(REPLAY_FRAME_MS, on_replay_tick, NULL);
+  replay_set_playing(1);
 }
 
-static void update_text_view(GtkWidget *view, void *arr, size_t size,
-                             DataType t) {
-  GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view));
-  if (!arr || size == 0) {
-    gtk_text_buffer_set_text(buffer, "", -1);
+static void on_replay_seek(GtkRange *range, gpointer data) {
+  if (widgets_sort->replay_updating || !widgets_sort->has_trace)
     return;
+  sort_replay_seek(&widgets_sort->replay,
+                   (uint64_t)gtk_range_get_value(range));
+  replay_show_position();
+}
+
+// One bar per slot, or per sampled slot when there are more slots than
+// pixels; the slots of the last replayed event are highlighted.
+static gboolean on_draw_replay(GtkWidget *widget, cairo_t *cr,
+                               gpointer data) {
+  double w = gtk_widget_get_allocated_width(widget);
+  double h = gtk_widget_get_allocated_height(widget);
+  cairo_set_source_rgb(cr, 1, 1, 1);
+  cairo_paint(cr);
+  if (!widgets_sort->has_trace || w < 1)
+    return FALSE;
+
+  SortReplay *r = &widgets_sort->replay;
+  size_t n = r->trace->n;
+  size_t cols = n < (size_t)w ? n : (size_t)w;
+  double bar = w / cols;
+  double lo = widgets_sort->trace_min, span = widgets_sort->trace_max - lo;
+  if (span <= 0)
+    span = 1;
+
+  cairo_set_source_rgb(cr, 0.55, 0.6, 0.65);
+  for (size_t c = 0; c < cols; c++) {
+    double v = widgets_sort->trace_values[r->slots[c * n / cols]];
+    double bh = 2 + (h - 2) * (v - lo) / span;
+    cairo_rectangle(cr, c * bar, h - bh, bar > 2 ? bar - 1 : bar, bh);
+  }
+  cairo_fill(cr);
+
+  if (r->pos == sort_trace_first(r->trace))
+    return FALSE;
+  TraceEvent e = sort_trace_event(r->trace, r->pos - 1);
+  static const double COLORS[][3] = {
+      [TRACE_CMP] = {0.94, 0.68, 0.31},  // Orange
+      [TRACE_SWAP] = {0.85, 0.33, 0.31}, // Red
+      [TRACE_MOVE] = {0.0, 0.48, 1.0},   // Blue
+  };
+  TraceOp op = TRACE_OP(e);
+  cairo_set_source_rgb(cr, COLORS[op][0], COLORS[op][1], COLORS[op][2]);
+  size_t ends[2] = {TRACE_I(e), TRACE_J(e)};
+  for (int k = 0; k < 2; k++) {
+    if (ends[k] == TRACE_TEMP)
+      continue;
+    size_t c = ends[k] * cols / n;
+    double v = widgets_sort->trace_values[r->slots[ends[k]]];
+    double bh = 2 + (h - 2) * (v - lo) / span;
+    cairo_rectangle(cr, c * bar, h - bh, bar > 3 ? bar - 1 : 3, bh);
   }
+  cairo_fill(cr);
+  return FALSE;
+}
+
+static void clear_sorted(void) {
+  free(widgets_sort->sorted);
+  widgets_sort->sorted = NULL;
+  data_view_set_data(widgets_sort->view_sorted, NULL, 0,
+                     widgets_sort->current_type);
+}
 
-  size_t limit = size > 500 ? 500 : size;
-  GString *gs = g_string_new("");
-  char temp[64];
-  for (size_t i = 0; i < limit; i++) {
-    switch (t) {
-    case TYPE_INT:
-      snprintf(temp, 64, "%d", ((int *)arr)[i]);
-      break;
-    case TYPE_DOUBLE:
-      snprintf(temp, 64, "%.2f", ((double *)arr)[i]);
-      break;
-    case TYPE_CHAR:
-      snprintf(temp, 64, "'%c'", ((char *)arr)[i]);
-      break;
-    case TYPE_STRING:
-      snprintf(temp, 64, "\"%s\"", ((char **)arr)[i]);
-      break;
+// Drops the data and the sorted copy, and empties both views
+static void free_data() {
+  widgets_sort->load_generation++; // A CSV load still running is dropped
+  clear_sorted();
+  data_view_set_data(widgets_sort->view_raw, NULL, 0,
+                     widgets_sort->current_type);
+  if (!widgets_sort->array)
+    return;
+  string_arena_free(&widgets_sort->strings);
+  if (widgets_sort->mapped.map)
+    array_file_close(&widgets_sort->mapped);
+  else
+    free(widgets_sort->array);
+  widgets_sort->array = NULL;
+  widgets_sort->size = 0;
+}
+
+// Turns a mapped array into a malloc'd one (strings into the arena), for
+// the edits that resize it. Returns 0, or -1 when out of memory.
+static int unmap_data() {
+  if (!widgets_sort->mapped.map)
+    return 0;
+  size_t n = widgets_sort->size;
+  size_t el_size = get_element_size(widgets_sort->current_type);
+  void *copy = malloc(n > 0 ? n * el_size : 1);
+  if (!copy)
+    return -1;
+  if (widgets_sort->current_type != TYPE_STRING) {
+    memcpy(copy, widgets_sort->array, n * el_size);
+  } else {
+    char **src = widgets_sort->array;
+    for (size_t i = 0; i < n; i++) {
+      ((char **)copy)[i] = string_arena_dup(&widgets_sort->strings, src[i]);
+      if (!((char **)copy)[i]) {
+        string_arena_free(&widgets_sort->strings);
+        free(copy);
+        return -1;
+      }
     }
-    g_string_append(gs, temp);
-    if (i < limit - 1)
-      g_string_append(gs, ", ");
   }
-  if (size > limit)
-    g_string_append(gs, "...");
-  gtk_text_buffer_set_text(buffer, gs->str, -1);
-  g_string_free(gs, TRUE);
+  array_file_close(&widgets_sort->mapped);
+  widgets_sort->array = copy;
+  return 0;
 }
 
 // --- NEW Manual Input Logic (Single Add) ---
@@ -276,6 +452,8 @@ static void on_add_manual_value(GtkWidget *btn, gpointer data) {
     return;
 
   // Resize array
+  if (unmap_data() != 0)
+    return;
   size_t new_size = widgets_sort->size + 1;
   size_t el_size = get_element_size(widgets_sort->current_type);
   void *new_arr = realloc(widgets_sort->array, new_size * el_size);
@@ -296,21 +474,26 @@ static void on_add_manual_value(GtkWidget *btn, gpointer data) {
   case TYPE_CHAR:
     ((char *)widgets_sort->array)[i] = text[0];
     break;
-  case TYPE_STRING:
-    ((char **)widgets_sort->array)[i] = strdup(text);
+  case TYPE_STRING: {
+    char *copy = string_arena_dup(&widgets_sort->strings, text);
+    if (!copy)
+      return; // Out of memory: the array keeps its size
+    ((char **)widgets_sort->array)[i] = copy;
     break;
   }
+  }
 
   widgets_sort->size = new_size;
 
   // Clear input
   gtk_entry_set_text(GTK_ENTRY(widgets_sort->entry_manual_val), "");
 
-  // Update View
-  update_text_view(widgets_sort->text_raw, widgets_sort->array,
-                   widgets_sort->size, widgets_sort->current_type);
+  // Update View, scrolled to the new value
+  data_view_set_data(widgets_sort->view_raw, widgets_sort->array,
+                     widgets_sort->size, widgets_sort->current_type);
+  data_view_scroll_to(widgets_sort->view_raw, i);
   // Clear sorted view since data changed
-  update_text_view(widgets_sort->text_sorted, NULL, 0, 0);
+  clear_sorted();
 
   // Reset benchmark data as content changed
   widgets_sort->has_bench_data = 0;
@@ -319,6 +502,82 @@ static void on_add_manual_value(GtkWidget *btn, gpointer data) {
 
 // --- Logic Actions ---
 
+// Labels of the distribution combo, indexed by Distribution
+static const char *DIST_LABELS[DIST_COUNT] = {
+    [DIST_RANDOM] = "Aléatoire",
+    [DIST_SORTED] = "Trié",
+    [DIST_REVERSED] = "Inversé",
+    [DIST_FEW_UNIQUE] = "Peu de valeurs distinctes",
+    [DIST_ORGAN_PIPE] = "Tuyaux d'orgue",
+    [DIST_SAWTOOTH] = "Dents de scie",
+    [DIST_NEARLY_SORTED] = "Presque trié",
+    [DIST_ZIPF] = "Zipf (asymétrique)",
+    [DIST_ALL_EQUAL] = "Tous égaux",
+    [DIST_SORTED_RUNS] = "Séquences triées",
+};
+
+// Placeholder of the parameter entry, NULL when the distribution has none
+static const char *dist_param_hint(Distribution d) {
+  switch (d) {
+  case DIST_FEW_UNIQUE:
+    return "Valeurs distinctes (16)";
+  case DIST_NEARLY_SORTED:
+    return "Échanges aléatoires (10)";
+  case DIST_SAWTOOTH:
+  case DIST_SORTED_RUNS:
+    return "Longueur des séquences (64)";
+  case DIST_ZIPF:
+    return "Exposant (1.0)";
+  default:
+    return NULL;
+  }
+}
+
+static void on_dist_changed(GtkComboBox *combo, gpointer data) {
+  const char *hint = dist_param_hint(gtk_combo_box_get_active(combo));
+  gtk_entry_set_placeholder_text(GTK_ENTRY(widgets_sort->entry_dist_param),
+                                 hint ? hint : "Sans paramètre");
+  gtk_widget_set_sensitive(widgets_sort->entry_dist_param, hint != NULL);
+}
+
+// Reads the distribution and its parameter (main thread only); an empty or
+// invalid entry keeps the default
+static Distribution read_dist_params(DistParams *p) {
+  Distribution d =
+      gtk_combo_box_get_active(GTK_COMBO_BOX(widgets_sort->combo_dist));
+  if ((unsigned)d >= DIST_COUNT)
+    d = DIST_RANDOM;
+  dist_default_params(p);
+  p->unique = 1000; // Zipf ranks
+  const char *text =
+      gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_dist_param));
+  long v = atol(text);
+  switch (d) {
+  case DIST_FEW_UNIQUE:
+    if (v > 0)
+      p->unique = (size_t)v;
+    else
+      p->unique = 16;
+    break;
+  case DIST_NEARLY_SORTED:
+    if (v > 0)
+      p->swaps = (size_t)v;
+    break;
+  case DIST_SAWTOOTH:
+  case DIST_SORTED_RUNS:
+    if (v > 0)
+      p->run_length = (size_t)v;
+    break;
+  case DIST_ZIPF:
+    if (atof(text) > 0)
+      p->zipf_s = atof(text);
+    break;
+  default:
+    break;
+  }
+  return d;
+}
+
 static void on_mode_toggled(GtkToggleButton *btn, gpointer data) {
   gboolean manual = gtk_toggle_button_get_active(
       GTK_TOGGLE_BUTTON(widgets_sort->radio_manual));
@@ -329,6 +588,31 @@ static void on_mode_toggled(GtkToggleButton *btn, gpointer data) {
     gtk_widget_hide(widgets_sort->box_manual_input);
 
   gtk_widget_set_sensitive(widgets_sort->entry_size, !manual);
+  gtk_widget_set_sensitive(widgets_sort->combo_dist, !manual);
+}
+
+// Element count typed in entry_size: digits only, as strtoull alone takes
+// "-1" for ULLONG_MAX, and at most max. Empty text and 0 give def; returns
+// -1 when the text is not such a count.
+static int read_count(const char *text, size_t def, size_t max,
+                      size_t *out) {
+  while (isspace((unsigned char)*text))
+    text++;
+  if (!*text) {
+    *out = def;
+    return 0;
+  }
+  if (!isdigit((unsigned char)*text))
+    return -1;
+  char *end;
+  errno = 0;
+  unsigned long long v = strtoull(text, &end, 10);
+  while (isspace((unsigned char)*end))
+    end++;
+  if (errno == ERANGE || *end || v > max)
+    return -1;
+  *out = v ? (size_t)v : def;
+  return 0;
 }
 
 static void on_generate(GtkWidget *btn, gpointer data) {
@@ -340,49 +624,50 @@ static void on_generate(GtkWidget *btn, gpointer data) {
     // User said "User inserts one value at a time".
     // So "Generate" button is primarily for Auto mode.
     // But let's verify display just in case.
-    update_text_view(widgets_sort->text_raw, widgets_sort->array,
-                     widgets_sort->size, widgets_sort->current_type);
+    data_view_set_data(widgets_sort->view_raw, widgets_sort->array,
+                       widgets_sort->size, widgets_sort->current_type);
     return;
   }
 
   // AUTO MODE Logic
   const char *size_str =
       gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_size));
-  int size = atoi(size_str);
-  if (size <= 0)
-    size = 100;
-  else if (size > 10000)
-    size = 10000;
+  // Generation is parallel and the views are virtual, so the bound is
+  // GEN_MAX_SIZE, or what size * el_size can address
+  size_t el_size = get_element_size(widgets_sort->current_type);
+  size_t max_size =
+      SIZE_MAX / el_size < GEN_MAX_SIZE ? SIZE_MAX / el_size : GEN_MAX_SIZE;
+  size_t size;
+  if (read_count(size_str, 100, max_size, &size) != 0) {
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "Taille invalide : entrez un nombre d'éléments entre 1 et %zu.",
+             max_size);
+    data_view_set_message(widgets_sort->view_raw, msg);
+    return;
+  }
+
+  DistParams params;
+  Distribution dist = read_dist_params(&params);
+  if (widgets_sort->current_type == TYPE_INT)
+    params.range = 1000; // Readable values, 0..999
 
   free_data();
-  widgets_sort->size = size;
-  widgets_sort->array =
-      malloc(size * get_element_size(widgets_sort->current_type));
-
-  for (int i = 0; i < size; i++) {
-    switch (widgets_sort->current_type) {
-    case TYPE_INT:
-      ((int *)widgets_sort->array)[i] = rand() % 1000;
-      break;
-    case TYPE_DOUBLE:
-      ((double *)widgets_sort->array)[i] = (rand() % 1000) / 10.0;
-      break;
-    case TYPE_CHAR:
-      ((char *)widgets_sort->array)[i] = 'A' + (rand() % 26);
-      break;
-    case TYPE_STRING: {
-      char buf[6];
-      for (int k = 0; k < 5; k++)
-        buf[k] = 'a' + rand() % 26;
-      buf[5] = 0;
-      ((char **)widgets_sort->array)[i] = strdup(buf);
-    } break;
-    }
+  void *arr = malloc(size * el_size);
+  if (!arr || generate_distribution(arr, size, widgets_sort->current_type,
+                                    dist, &params, (unsigned)rand(),
+                                    &widgets_sort->strings) != 0) {
+    free(arr);
+    string_arena_free(&widgets_sort->strings);
+    data_view_set_message(widgets_sort->view_raw,
+                          "Mémoire insuffisante pour générer les données.");
+    return;
   }
+  widgets_sort->array = arr;
+  widgets_sort->size = size;
 
-  update_text_view(widgets_sort->text_raw, widgets_sort->array,
-                   widgets_sort->size, widgets_sort->current_type);
-  update_text_view(widgets_sort->text_sorted, NULL, 0, 0);
+  data_view_set_data(widgets_sort->view_raw, widgets_sort->array,
+                     widgets_sort->size, widgets_sort->current_type);
   widgets_sort->has_bench_data = 0;
   gtk_widget_queue_draw(widgets_sort->drawing_area);
 }
@@ -392,69 +677,137 @@ static void on_type_changed(GtkComboBox *combo, gpointer data) {
   if (new_type != widgets_sort->current_type) {
     widgets_sort->current_type = new_type;
     free_data(); // Clear data on type change to avoid corruption
-    update_text_view(widgets_sort->text_raw, NULL, 0, 0);
-    update_text_view(widgets_sort->text_sorted, NULL, 0, 0);
   }
 }
 
-static void copy_data(void *dest, void *src, size_t size, DataType t) {
-  size_t es = get_element_size(t);
-  if (t == TYPE_STRING) {
-    char **s_src = (char **)src;
-    char **s_dest = (char **)dest;
-    for (size_t i = 0; i < size; i++)
-      s_dest[i] = strdup(s_src[i]);
-  } else {
-    memcpy(dest, src, size * es);
-  }
+// Comparison sorts always apply; the others need a typed kernel
+static int algo_supported(int id, DataType t) {
+  if (id != ALGO_RADIX && id != ALGO_MULTIKEY && id != ALGO_PREFIX)
+    return 1;
+  return get_sort_kernel(t, id) != NULL;
 }
 
 static void run_algo(int id) {
   if (!widgets_sort->array || widgets_sort->size == 0)
     return;
+  if (!algo_supported(id, widgets_sort->current_type)) {
+    clear_sorted();
+    data_view_set_message(
+        widgets_sort->view_sorted,
+        id == ALGO_RADIX
+            ? "Tri Radix : disponible pour les entiers et les réels."
+        : id == ALGO_MULTIKEY
+            ? "Tri Multiclé : disponible pour les chaînes uniquement."
+            : "Tri Préfixes : disponible pour les chaînes uniquement.");
+    return;
+  }
 
   size_t el_size = get_element_size(widgets_sort->current_type);
   void *copy = malloc(widgets_sort->size * el_size);
-  copy_data(copy, widgets_sort->array, widgets_sort->size,
-            widgets_sort->current_type);
-
-  SortStats stats = {0, 0};
-  CompareFunc cmp = get_comparator(widgets_sort->current_type);
-
-  switch (id) {
-  case 0:
-    sort_bubble_gen(copy, widgets_sort->size, el_size, cmp, &stats);
-    break;
-  case 1:
-    sort_insertion_gen(copy, widgets_sort->size, el_size, cmp, &stats);
-    break;
-  case 2:
-    sort_shell_gen(copy, widgets_sort->size, el_size, cmp, &stats);
-    break;
-  case 3:
-    sort_quick_gen(copy, widgets_sort->size, el_size, cmp, &stats);
-    break;
-  }
-
-  update_text_view(widgets_sort->text_sorted, copy, widgets_sort->size,
-                   widgets_sort->current_type);
-
-  if (widgets_sort->current_type == TYPE_STRING) {
-    for (size_t i = 0; i < widgets_sort->size; i++)
-      free(((char **)copy)[i]);
+  if (!copy)
+    return;
+  // Strings stay in widgets_sort->strings: the sort only permutes a copy
+  // of the pointers
+  memcpy(copy, widgets_sort->array, widgets_sort->size * el_size);
+
+  SortStats stats = {0, 0, 0};
+  apply_parallel_config();
+  // The traced kernels count like the others, but have no sorting network
+  // or counting-sort shortcut
+  if (!gtk_toggle_button_get_active(
+          GTK_TOGGLE_BUTTON(widgets_sort->check_trace)) ||
+      record_trace(id, copy, &stats) != 0)
+    run_sort(id, copy, widgets_sort->size, widgets_sort->current_type, 1,
+             &stats);
+
+  // The copy stays alive behind the sorted view
+  clear_sorted();
+  widgets_sort->sorted = copy;
+  data_view_set_data(widgets_sort->view_sorted, copy, widgets_sort->size,
+                     widgets_sort->current_type);
+  if (id == ALGO_PREFIX) {
+    // Comparisons settled by the cached prefixes, above the values
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "Comparaisons : %lu, dont %lu sans strcmp (%.1f %%)",
+             stats.comparisons, stats.avoided,
+             stats.comparisons ? 100.0 * stats.avoided / stats.comparisons
+                               : 0.0);
+    data_view_set_message(widgets_sort->view_sorted, msg);
   }
-  free(copy);
 }
 
 static void on_sort_bubble(GtkWidget *btn, gpointer data) { run_algo(0); }
 static void on_sort_insert(GtkWidget *btn, gpointer data) { run_algo(1); }
 static void on_sort_shell(GtkWidget *btn, gpointer data) { run_algo(2); }
 static void on_sort_quick(GtkWidget *btn, gpointer data) { run_algo(3); }
+static void on_sort_radix(GtkWidget *btn, gpointer data) { run_algo(4); }
+static void on_sort_par_quick(GtkWidget *btn, gpointer data) { run_algo(5); }
+static void on_sort_par_merge(GtkWidget *btn, gpointer data) { run_algo(6); }
+static void on_sort_multikey(GtkWidget *btn, gpointer data) { run_algo(7); }
+static void on_sort_natural(GtkWidget *btn, gpointer data) { run_algo(8); }
+static void on_sort_prefix(GtkWidget *btn, gpointer data) { run_algo(9); }
+
+// Selection queries: only part of the order, without a full sort. The
+// result is kept behind the sorted view like a sort's.
+static void run_select(SelectOp op) {
+  if (!widgets_sort->array || widgets_sort->size == 0)
+    return;
+  size_t n = widgets_sort->size;
+  // Defaults as in sorter_bench -e: the median, the 100 smallest / largest
+  const char *k_str = gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_k));
+  size_t k = *k_str ? strtoull(k_str, NULL, 10)
+             : op == SELECT_NTH ? n / 2
+                                : 100;
+  if (op == SELECT_NTH && k >= n)
+    k = n - 1;
+  if (k > n)
+    k = n;
+
+  size_t el_size = get_element_size(widgets_sort->current_type);
+  void *copy = malloc(n * el_size);
+  if (!copy)
+    return;
+  memcpy(copy, widgets_sort->array, n * el_size);
+  SortStats stats = {0, 0, 0};
+  get_select_kernel(widgets_sort->current_type, op)(copy, n, k, &stats);
+
+  clear_sorted();
+  widgets_sort->sorted = copy;
+  char msg[160];
+  if (op == SELECT_NTH) {
+    // The whole array, partitioned around rank k
+    data_view_set_data(widgets_sort->view_sorted, copy, n,
+                       widgets_sort->current_type);
+    data_view_highlight(widgets_sort->view_sorted, k, k + 1);
+    data_view_scroll_to(widgets_sort->view_sorted, k);
+    snprintf(msg, sizeof(msg),
+             "Élément de rang %zu (surligné) : %lu comparaisons", k,
+             stats.comparisons);
+  } else {
+    // Only the k results
+    data_view_set_data(widgets_sort->view_sorted, copy, k,
+                       widgets_sort->current_type);
+    snprintf(msg, sizeof(msg), "Les %zu plus %s : %lu comparaisons", k,
+             op == SELECT_PARTIAL ? "petits, triés" : "grands, décroissants",
+             stats.comparisons);
+  }
+  data_view_set_message(widgets_sort->view_sorted, msg);
+}
+
+static void on_select_nth(GtkWidget *btn, gpointer data) {
+  run_select(SELECT_NTH);
+}
+static void on_select_partial(GtkWidget *btn, gpointer data) {
+  run_select(SELECT_PARTIAL);
+}
+static void on_select_top_k(GtkWidget *btn, gpointer data) {
+  run_select(SELECT_TOP_K);
+}
 
 static void on_reset(GtkWidget *btn, gpointer data) {
   free_data();
-  update_text_view(widgets_sort->text_raw, NULL, 0, 0);
-  update_text_view(widgets_sort->text_sorted, NULL, 0, 0);
+  replay_clear();
   gtk_entry_set_text(GTK_ENTRY(widgets_sort->entry_manual_val), "");
   widgets_sort->has_bench_data = 0;
   gtk_widget_queue_draw(widgets_sort->drawing_area);
@@ -462,6 +815,22 @@ static void on_reset(GtkWidget *btn, gpointer data) {
 
 // --- Persistence ---
 
+// Progress of external sorts, shown while they run (the sort button is
+// insensitive meanwhile)
+static void on_file_progress(double fraction, void *user) {
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(widgets_sort->progress_ext),
+                                fraction);
+  while (gtk_events_pending())
+    gtk_main_iteration();
+}
+
+// Binary array files are told apart by their extension when saving, by
+// their magic when loading
+static int is_binary_name(const char *filename) {
+  size_t len = strlen(filename);
+  return len >= 4 && g_ascii_strcasecmp(filename + len - 4, ".bin") == 0;
+}
+
 static void on_save(GtkWidget *btn, gpointer data) {
   if (!widgets_sort->array || widgets_sort->size == 0)
     return;
@@ -475,29 +844,56 @@ static void on_save(GtkWidget *btn, gpointer data) {
 
   if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
     char *filename = gtk_file_chooser_get_filename(chooser);
-    FILE *f = fopen(filename, "w");
+    // .bin: the array as it is in memory, reloaded by mapping it
+    FILE *f = NULL;
+    if (is_binary_name(filename)) {
+      if (array_file_save(filename, widgets_sort->array, widgets_sort->size,
+                          widgets_sort->current_type) != 0)
+        data_view_set_message(widgets_sort->view_raw,
+                              "Échec de la sauvegarde binaire.");
+    } else
+      f = fopen(filename, "w");
     if (f) {
       // Write Type Header
       fprintf(f, "%d\n", widgets_sort->current_type);
-      // Write Elements
+      // Write Elements, formatted into a buffer written in large blocks.
+      // Doubles in their shortest exact form, so a reload is lossless.
+      char out[65536];
+      size_t used = 0, room = sizeof(out) - 64; // 64: one number + ','
       for (size_t i = 0; i < widgets_sort->size; i++) {
+        if (used > room) {
+          fwrite(out, 1, used, f);
+          used = 0;
+        }
         switch (widgets_sort->current_type) {
         case TYPE_INT:
-          fprintf(f, "%d", ((int *)widgets_sort->array)[i]);
+          used += fmt_int64(out + used, ((int *)widgets_sort->array)[i]);
           break;
         case TYPE_DOUBLE:
-          fprintf(f, "%.4f", ((double *)widgets_sort->array)[i]);
+          used += fmt_double(out + used, ((double *)widgets_sort->array)[i]);
           break;
         case TYPE_CHAR:
-          fprintf(f, "%c", ((char *)widgets_sort->array)[i]);
-          break;
-        case TYPE_STRING:
-          fprintf(f, "%s", ((char **)widgets_sort->array)[i]);
+          out[used++] = ((char *)widgets_sort->array)[i];
           break;
+        case TYPE_STRING: {
+          const char *str = ((char **)widgets_sort->array)[i];
+          size_t len = strlen(str);
+          if (len > room - used) {
+            fwrite(out, 1, used, f);
+            used = 0;
+          }
+          if (len > room) {
+            fwrite(str, 1, len, f);
+          } else {
+            memcpy(out + used, str, len);
+            used += len;
+          }
+        } break;
         }
         if (i < widgets_sort->size - 1)
-          fprintf(f, ",");
+          out[used++] = ',';
       }
+      fwrite(out, 1, used, f);
       fclose(f);
     }
     g_free(filename);
@@ -505,6 +901,95 @@ static void on_save(GtkWidget *btn, gpointer data) {
   gtk_widget_destroy(dialog);
 }
 
+// CSV loads run on a worker thread. The array and its strings stay private
+// to the LoadJob until on_load_done installs them on the GUI thread, so the
+// tab remains usable meanwhile; free_data (reset, generation, type change,
+// another load) bumps load_generation and the finished load is dropped.
+typedef struct {
+  char *filename;
+  guint generation;
+  DataType type;
+  void *arr;
+  size_t count;
+  StringArena strings;
+} LoadJob;
+
+typedef struct {
+  guint generation;
+  double fraction;
+} LoadProgress;
+
+static void load_job_free(gpointer data) {
+  LoadJob *job = data;
+  free(job->arr);
+  string_arena_free(&job->strings);
+  g_free(job->filename);
+  g_free(job);
+}
+
+static gboolean on_load_progress(gpointer data) {
+  LoadProgress *lp = data;
+  if (lp->generation == widgets_sort->load_generation)
+    gtk_progress_bar_set_fraction(
+        GTK_PROGRESS_BAR(widgets_sort->progress_ext), lp->fraction);
+  g_free(lp);
+  return G_SOURCE_REMOVE;
+}
+
+// Called by csv_read_array on the worker thread
+static void post_load_progress(double fraction, void *user) {
+  LoadJob *job = user;
+  LoadProgress *lp = g_new(LoadProgress, 1);
+  lp->generation = job->generation;
+  lp->fraction = fraction;
+  g_idle_add(on_load_progress, lp);
+}
+
+static void load_thread(GTask *task, gpointer source, gpointer task_data,
+                        GCancellable *cancellable) {
+  LoadJob *job = task_data;
+  FILE *f = fopen(job->filename, "r");
+  int type_int;
+  gboolean ok = f && fscanf(f, "%d\n", &type_int) == 1 &&
+                type_int >= TYPE_INT && type_int < TYPE_CUSTOM;
+  if (ok) {
+    // Values streamed block by block into an array grown as needed
+    job->type = (DataType)type_int;
+    ok = csv_read_array(f, " ,\n\r", job->type, &job->strings,
+                        post_load_progress, job, &job->arr,
+                        &job->count) == 0;
+  }
+  if (f)
+    fclose(f);
+  g_task_return_boolean(task, ok);
+}
+
+static void on_load_done(GObject *source, GAsyncResult *res, gpointer data) {
+  LoadJob *job = g_task_get_task_data(G_TASK(res));
+  gboolean ok = g_task_propagate_boolean(G_TASK(res), NULL);
+  if (job->generation != widgets_sort->load_generation)
+    return; // Superseded, load_job_free drops it
+  if (!ok) {
+    data_view_set_message(widgets_sort->view_raw,
+                          "Lecture du fichier impossible.");
+    return;
+  }
+  // The job hands its array and strings over to the tab
+  free_data();
+  widgets_sort->strings = job->strings;
+  string_arena_init(&job->strings);
+  widgets_sort->current_type = job->type;
+  widgets_sort->array = job->arr;
+  widgets_sort->size = job->count;
+  job->arr = NULL;
+  // Update UI
+  gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_sort->combo_type),
+                           job->type);
+  // Don't necessarily switch to manual, but update data
+  data_view_set_data(widgets_sort->view_raw, widgets_sort->array,
+                     widgets_sort->size, widgets_sort->current_type);
+}
+
 static void on_load(GtkWidget *btn, gpointer data) {
   GtkWidget *dialog = gtk_file_chooser_dialog_new(
       "Charger", NULL, GTK_FILE_CHOOSER_ACTION_OPEN, "Annuler",
@@ -512,165 +997,363 @@ static void on_load(GtkWidget *btn, gpointer data) {
 
   if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
     char *filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
-    FILE *f = fopen(filename, "r");
-    if (f) {
-      int type_int;
-      if (fscanf(f, "%d\n", &type_int) == 1) {
-        // Read rest of file
-        fseek(f, 0, SEEK_END);
-        long fsize = ftell(f);
-        fseek(f, 0, SEEK_SET);
-        char line[256];
-        fgets(line, sizeof(line), f); // Skip 1st line
-
-        long data_pos = ftell(f);
-        long data_len = fsize - data_pos;
-
-        if (data_len > 0) {
-          char *buf = malloc(data_len + 1);
-          fread(buf, 1, data_len, f);
-          buf[data_len] = 0;
-
-          // Free existing
-          free_data();
-
-          // Re-Implement parse from csv buffer logic or similar
-          // For simplicity, reusing basic token parsing for load
-          size_t count = 0;
-          char *dup = strdup(buf);
-          char *p = strtok(dup, " ,\n\r");
-          while (p) {
-            count++;
-            p = strtok(NULL, " ,\n\r");
-          }
-          free(dup);
-
-          widgets_sort->current_type = (DataType)type_int;
-          widgets_sort->size = count;
-          widgets_sort->array =
-              malloc(count * get_element_size(widgets_sort->current_type));
-
-          dup = strdup(buf);
-          p = strtok(dup, " ,\n\r");
-          size_t i = 0;
-          while (p && i < count) {
-            switch (widgets_sort->current_type) {
-            case TYPE_INT:
-              ((int *)widgets_sort->array)[i] = atoi(p);
-              break;
-            case TYPE_DOUBLE:
-              ((double *)widgets_sort->array)[i] = atof(p);
-              break;
-            case TYPE_CHAR:
-              ((char *)widgets_sort->array)[i] = p[0];
-              break;
-            case TYPE_STRING:
-              ((char **)widgets_sort->array)[i] = strdup(p);
-              break;
-            }
-            i++;
-            p = strtok(NULL, " ,\n\r");
-          }
-          free(dup);
-          free(buf);
-
-          // Update UI
-          gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_sort->combo_type),
-                                   type_int);
-          // Don't necessarily switch to manual, but update data
-          update_text_view(widgets_sort->text_raw, widgets_sort->array,
+    if (!array_file_detect(filename)) {
+      LoadJob *job = g_new0(LoadJob, 1);
+      job->filename = filename;
+      string_arena_init(&job->strings);
+      job->generation = ++widgets_sort->load_generation;
+      gtk_progress_bar_set_fraction(
+          GTK_PROGRESS_BAR(widgets_sort->progress_ext), 0);
+      GTask *task = g_task_new(NULL, NULL, on_load_done, NULL);
+      g_task_set_task_data(task, job, load_job_free);
+      g_task_run_in_thread(task, load_thread);
+      g_object_unref(task);
+    } else {
+      // Binary files are mapped and shown in place, nothing is parsed
+      ArrayFile af;
+      if (array_file_open(filename, &af) == 0) {
+        free_data();
+        widgets_sort->mapped = af;
+        widgets_sort->array = af.array;
+        widgets_sort->size = af.count;
+        widgets_sort->current_type = af.type;
+        gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_sort->combo_type),
+                                 af.type);
+        data_view_set_data(widgets_sort->view_raw, widgets_sort->array,
                            widgets_sort->size, widgets_sort->current_type);
-          update_text_view(widgets_sort->text_sorted, NULL, 0, 0);
-        }
+      } else {
+        data_view_set_message(widgets_sort->view_raw,
+                              "Fichier binaire invalide.");
       }
-      fclose(f);
+      g_free(filename);
     }
-    g_free(filename);
   }
   gtk_widget_destroy(dialog);
 }
 
+// --- External Sort (file to file, bounded memory) ---
+
+static char *choose_file(const char *title, GtkFileChooserAction action,
+                         const char *accept) {
+  GtkWidget *dialog = gtk_file_chooser_dialog_new(
+      title, NULL, action, "Annuler", GTK_RESPONSE_CANCEL, accept,
+      GTK_RESPONSE_ACCEPT, NULL);
+  if (action == GTK_FILE_CHOOSER_ACTION_SAVE) {
+    gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(dialog),
+                                                   TRUE);
+    gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(dialog),
+                                      "data_sorted.csv");
+  }
+  char *filename = NULL;
+  if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT)
+    filename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+  gtk_widget_destroy(dialog);
+  return filename;
+}
+
+static void on_external_sort(GtkWidget *btn, gpointer data) {
+  char *in = choose_file("Fichier à trier", GTK_FILE_CHOOSER_ACTION_OPEN,
+                         "Ouvrir");
+  if (!in)
+    return;
+  char *out = choose_file("Fichier trié", GTK_FILE_CHOOSER_ACTION_SAVE,
+                          "Sauvegarder");
+  if (!out) {
+    g_free(in);
+    return;
+  }
+
+  // Memory budget in MB (default 64)
+  int mb = atoi(gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_ext_mem)));
+  size_t mem = (size_t)(mb > 0 ? mb : 64) * 1024 * 1024;
+
+  SortStats stats = {0, 0, 0};
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(widgets_sort->progress_ext),
+                                0);
+  gtk_widget_set_sensitive(btn, FALSE);
+  int rc = sort_external_file(in, out, mem, on_file_progress, NULL, &stats);
+  gtk_widget_set_sensitive(btn, TRUE);
+
+  char msg[256];
+  if (rc == 0)
+    snprintf(msg, sizeof(msg),
+             "Tri externe terminé.\nComparaisons : %lu\nÉcritures : %lu",
+             stats.comparisons, stats.assignments);
+  else
+    snprintf(msg, sizeof(msg), "Tri externe : échec (fichier illisible ou "
+                               "format invalide).");
+  clear_sorted();
+  data_view_set_message(widgets_sort->view_sorted, msg);
+  g_free(in);
+  g_free(out);
+}
+
+// One (algorithm, size) point measured by bench_measure: every run sorts a
+// fresh copy of the same input (pointer copies for strings)
+typedef struct {
+  SortAlgo algo;
+  DataType type;
+  const void *src;
+  void *arr;
+  size_t n;
+} CompareRun;
+
+static void compare_setup(void *p) {
+  CompareRun *cr = p;
+  memcpy(cr->arr, cr->src, cr->n * get_element_size(cr->type));
+}
+
+static void compare_run(void *p) {
+  CompareRun *cr = p;
+  SortStats stats = {0, 0, 0};
+  run_sort(cr->algo, cr->arr, cr->n, cr->type, 0, &stats);
+}
+
+// --- Background comparison ---
+// The comparison runs in a GTask worker thread. Each measured point is sent
+// back to the main loop with g_idle_add, so the chart fills in while the
+// window stays responsive. Cancelling stops at the next timed run.
+
+typedef struct {
+  DataType type;
+  Distribution dist;
+  DistParams params;
+  unsigned seed; // Input of size i generated from seed + i
+  int sizes[MAX_POINTS];
+  int active[NB_ALGOS];
+  int total; // Points to measure
+  guint generation;
+  atomic_int cancel; // Set by the GUI thread, read between runs
+} CompareJob;
+
+typedef struct {
+  guint generation;
+  int algo, point;
+  int done, total;
+  BenchResult result;
+} ComparePoint;
+
+static gboolean on_compare_point(gpointer data) {
+  ComparePoint *pt = data;
+  // Late update from a previous (cancelled) comparison
+  if (pt->generation == widgets_sort->compare_generation) {
+    AlgoBenchmark *bench = &widgets_sort->benches[pt->algo];
+    bench->results[pt->point] = pt->result;
+    bench->nb_points = pt->point + 1;
+    if (widgets_sort->compare_job) {
+      char text[64];
+      snprintf(text, sizeof(text), "%s : %d / %d", bench->name, pt->done,
+               pt->total);
+      gtk_progress_bar_set_fraction(
+          GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+          (double)pt->done / pt->total);
+      gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                                text);
+    }
+    gtk_widget_queue_draw(widgets_sort->drawing_area);
+  }
+  g_free(pt);
+  return G_SOURCE_REMOVE;
+}
+
+static void compare_thread(GTask *task, gpointer source, gpointer task_data,
+                           GCancellable *cancellable) {
+  CompareJob *job = task_data;
+  size_t es = get_element_size(job->type);
+  BenchOptions opt;
+  bench_default_options(&opt);
+  opt.cancel = &job->cancel;
+  opt.hw_counters = 1; // Chart Y axis choices, left empty when unavailable
+
+  // One sort buffer for the whole comparison, sized for the largest point
+  void *work = malloc(job->sizes[MAX_POINTS - 1] * es);
+  int done = 0;
+  for (int i = 0; i < MAX_POINTS && !atomic_load(&job->cancel); i++) {
+    // Generated data (selected distribution), not the manual array. Each
+    // size is generated once and every algorithm sorts a memcpy clone.
+    int n = job->sizes[i];
+    void *arr = malloc(n * es);
+    StringArena strings;
+    string_arena_init(&strings);
+    int ready = arr && work &&
+                generate_distribution(arr, n, job->type, job->dist,
+                                      &job->params, job->seed + (unsigned)i,
+                                      &strings) == 0;
+
+    for (int b = 0; b < NB_ALGOS && !atomic_load(&job->cancel); b++) {
+      if (!job->active[b])
+        continue;
+      ComparePoint *pt = g_new0(ComparePoint, 1);
+      pt->generation = job->generation;
+      pt->algo = b;
+      pt->point = i;
+      pt->total = job->total;
+      CompareRun run = {b, job->type, arr, work, n};
+      if (ready && bench_measure(&opt, compare_setup, compare_run, &run,
+                                 &pt->result) != 0)
+        memset(&pt->result, 0, sizeof(BenchResult));
+
+      if (atomic_load(&job->cancel)) {
+        g_free(pt); // Interrupted point: not plotted
+        break;
+      }
+      pt->done = ++done;
+      g_idle_add(on_compare_point, pt);
+    }
+    string_arena_free(&strings);
+    free(arr);
+  }
+  free(work);
+  g_task_return_boolean(task, !atomic_load(&job->cancel));
+}
+
+static void on_compare_done(GObject *source, GAsyncResult *res,
+                            gpointer data) {
+  CompareJob *job = g_task_get_task_data(G_TASK(res));
+  gboolean finished = g_task_propagate_boolean(G_TASK(res), NULL);
+  if (job == widgets_sort->compare_job) {
+    widgets_sort->compare_job = NULL;
+    gtk_widget_set_sensitive(widgets_sort->btn_compare, TRUE);
+    gtk_widget_set_sensitive(widgets_sort->btn_cancel_cmp, FALSE);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                              finished ? "Comparaison terminée"
+                                       : "Comparaison annulée");
+    if (finished)
+      gtk_progress_bar_set_fraction(
+          GTK_PROGRESS_BAR(widgets_sort->progress_cmp), 1.0);
+  }
+}
+
+static void on_cancel_compare(GtkWidget *btn, gpointer data) {
+  CompareJob *job = widgets_sort->compare_job;
+  if (!job)
+    return;
+  atomic_store(&job->cancel, 1);
+  g_cancellable_cancel(widgets_sort->compare_cancel);
+  gtk_widget_set_sensitive(widgets_sort->btn_cancel_cmp, FALSE);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                            "Annulation...");
+}
+
 static void on_compare_all(GtkWidget *btn, gpointer data) {
+  if (widgets_sort->compare_job)
+    return; // Already running
+
   // Dynamic Size Calculation
   const char *s_n = gtk_entry_get_text(GTK_ENTRY(widgets_sort->entry_size));
   int max_n = atoi(s_n);
   if (max_n <= 0)
     max_n = 1000;
 
+  CompareJob *job = g_new0(CompareJob, 1);
+  job->type = widgets_sort->current_type;
+  job->dist = read_dist_params(&job->params);
+  if (job->type == TYPE_INT)
+    job->params.range = 10000;
+  job->seed = g_random_int();
+  job->generation = ++widgets_sort->compare_generation;
+
   // Create 5 steps
   for (int i = 0; i < MAX_POINTS; i++) {
     BENCH_SIZES[i] = (max_n * (i + 1)) / MAX_POINTS;
     if (BENCH_SIZES[i] == 0)
       BENCH_SIZES[i] = 1;
+    job->sizes[i] = BENCH_SIZES[i];
   }
 
-  CompareFunc cmp = get_comparator(widgets_sort->current_type);
-  size_t es = get_element_size(widgets_sort->current_type);
-
-  AlgoBenchmark *benches[] = {
-      &widgets_sort->bench_bulle, &widgets_sort->bench_insertion,
-      &widgets_sort->bench_shell, &widgets_sort->bench_quick};
-
-  for (int b = 0; b < 4; b++) {
-    for (int i = 0; i < MAX_POINTS; i++) {
-      // Benchmark requires Random data, not manual
-      int n = BENCH_SIZES[i];
-      void *arr = malloc(n * es);
-
-      for (int k = 0; k < n; k++) {
-        switch (widgets_sort->current_type) {
-        case TYPE_INT:
-          ((int *)arr)[k] = rand() % 10000;
-          break;
-        case TYPE_DOUBLE:
-          ((double *)arr)[k] = (double)rand() / RAND_MAX * 1000.0;
-          break;
-        case TYPE_CHAR:
-          ((char *)arr)[k] = 'A' + rand() % 26;
-          break;
-        case TYPE_STRING: {
-          char buf[5];
-          for (int j = 0; j < 4; j++)
-            buf[j] = 'a' + rand() % 26;
-          buf[4] = 0;
-          ((char **)arr)[k] = strdup(buf);
-        } break;
-        }
-      }
-
-      SortStats stats = {0, 0};
-      clock_t start = clock();
-      switch (b) {
-      case 0:
-        sort_bubble_gen(arr, n, es, cmp, &stats);
-        break;
-      case 1:
-        sort_insertion_gen(arr, n, es, cmp, &stats);
-        break;
-      case 2:
-        sort_shell_gen(arr, n, es, cmp, &stats);
-        break;
-      case 3:
-        sort_quick_gen(arr, n, es, cmp, &stats);
-        break;
-      }
-      clock_t end = clock();
-      benches[b]->times[i] = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
-
-      if (widgets_sort->current_type == TYPE_STRING) {
-        for (int k = 0; k < n; k++)
-          free(((char **)arr)[k]);
-      }
-      free(arr);
-    }
+  AlgoBenchmark *benches = widgets_sort->benches;
+  for (int b = 0; b < NB_ALGOS; b++) {
+    benches[b].active = algo_supported(b, job->type);
+    benches[b].nb_points = 0;
+    job->active[b] = benches[b].active;
+    if (job->active[b])
+      job->total += MAX_POINTS;
   }
   widgets_sort->has_bench_data = 1;
   gtk_widget_queue_draw(widgets_sort->drawing_area);
+
+  // Thread count and cutoff are read here, on the main thread
+  apply_parallel_config();
+
+  if (widgets_sort->compare_cancel)
+    g_object_unref(widgets_sort->compare_cancel);
+  widgets_sort->compare_cancel = g_cancellable_new();
+  widgets_sort->compare_job = job;
+  gtk_widget_set_sensitive(widgets_sort->btn_compare, FALSE);
+  gtk_widget_set_sensitive(widgets_sort->btn_cancel_cmp, TRUE);
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                                0.0);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                            "Comparaison en cours...");
+
+  GTask *task = g_task_new(NULL, widgets_sort->compare_cancel,
+                           on_compare_done, NULL);
+  g_task_set_task_data(task, job, g_free);
+  g_task_run_in_thread(task, compare_thread);
+  g_object_unref(task);
 }
 
 // --- Chart Drawing (Same as before) ---
 
+static void draw_marker(cairo_t *cr, int type, double x, double y) {
+  cairo_new_path(cr);
+  if (type == 0)
+    cairo_arc(cr, x, y, 3, 0, 2 * G_PI);
+  else if (type == 1)
+    cairo_rectangle(cr, x - 3, y - 3, 6, 6);
+  else if (type == 2) {
+    cairo_move_to(cr, x, y - 4);
+    cairo_line_to(cr, x + 3, y + 3);
+    cairo_line_to(cr, x - 3, y + 3);
+    cairo_close_path(cr);
+  } else if (type == 3) {
+    cairo_move_to(cr, x, y - 4);
+    cairo_line_to(cr, x + 3, y);
+    cairo_line_to(cr, x, y + 4);
+    cairo_line_to(cr, x - 3, y);
+    cairo_close_path(cr);
+  } else if (type == 5) {
+    cairo_move_to(cr, x, y + 4);
+    cairo_line_to(cr, x + 3, y - 3);
+    cairo_line_to(cr, x - 3, y - 3);
+    cairo_close_path(cr);
+  } else if (type == 6) {
+    cairo_arc(cr, x, y, 3.5, 0, 2 * G_PI);
+    cairo_stroke(cr);
+    return;
+  } else if (type == 7) {
+    cairo_move_to(cr, x - 4, y);
+    cairo_line_to(cr, x + 4, y);
+    cairo_move_to(cr, x, y - 4);
+    cairo_line_to(cr, x, y + 4);
+    cairo_stroke(cr);
+    return;
+  } else if (type == 8) {
+    cairo_rectangle(cr, x - 3.5, y - 3.5, 7, 7);
+    cairo_stroke(cr);
+    return;
+  } else if (type == 9) {
+    cairo_move_to(cr, x, y - 4.5);
+    cairo_line_to(cr, x + 3.5, y);
+    cairo_line_to(cr, x, y + 4.5);
+    cairo_line_to(cr, x - 3.5, y);
+    cairo_close_path(cr);
+    cairo_stroke(cr);
+    return;
+  } else {
+    cairo_move_to(cr, x - 3, y - 3);
+    cairo_line_to(cr, x + 3, y + 3);
+    cairo_move_to(cr, x + 3, y - 3);
+    cairo_line_to(cr, x - 3, y + 3);
+    cairo_stroke(cr);
+    return;
+  }
+  cairo_fill(cr);
+}
+
 static void draw_chart(cairo_t *cr, double w, double h) {
+  ChartMetric metric =
+      gtk_combo_box_get_active(GTK_COMBO_BOX(widgets_sort->combo_metric));
   double margin = 50.0;
   double graph_w = w - 2 * margin;
   double graph_h = h - 2 * margin;
@@ -707,7 +1390,7 @@ static void draw_chart(cairo_t *cr, double w, double h) {
   cairo_set_font_size(cr, 12);
   cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
                          CAIRO_FONT_WEIGHT_BOLD);
-  cairo_show_text(cr, "Temps (ms)");
+  cairo_show_text(cr, chart_metric_label(metric));
   cairo_restore(cr);
 
   cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
@@ -721,24 +1404,44 @@ static void draw_chart(cairo_t *cr, double w, double h) {
   if (!widgets_sort->has_bench_data)
     return;
 
-  double max_time = 0;
-  AlgoBenchmark *benches[] = {
-      &widgets_sort->bench_bulle, &widgets_sort->bench_insertion,
-      &widgets_sort->bench_shell, &widgets_sort->bench_quick};
-  for (int b = 0; b < 4; b++)
-    for (int i = 0; i < MAX_POINTS; i++)
-      if (benches[b]->times[i] > max_time)
-        max_time = benches[b]->times[i];
-  if (max_time == 0)
-    max_time = 1;
+  double max_val = 0, v;
+  AlgoBenchmark *benches = widgets_sort->benches;
+  int nb_active = 0, nb_values = 0;
+  for (int b = 0; b < NB_ALGOS; b++) {
+    if (!benches[b].active)
+      continue;
+    nb_active++;
+    for (int i = 0; i < benches[b].nb_points; i++) {
+      const BenchResult *r = &benches[b].results[i];
+      if (chart_metric_value(r, metric, &v) != 0)
+        continue;
+      nb_values++;
+      if (metric == METRIC_TIME)
+        v = r->p95; // Room for the error bars
+      if (v > max_val)
+        max_val = v;
+    }
+  }
+  if (max_val == 0)
+    max_val = 1;
+
+  if (metric != METRIC_TIME && nb_values == 0) {
+    const char *msg = "Compteurs matériels indisponibles sur ce système";
+    cairo_set_source_rgb(cr, 0.5, 0.5, 0.5);
+    cairo_set_font_size(cr, 12);
+    cairo_text_extents(cr, msg, &ext);
+    cairo_move_to(cr, w / 2 - ext.width / 2, h / 2);
+    cairo_show_text(cr, msg);
+    return;
+  }
 
   cairo_set_font_size(cr, 10);
   cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL,
                          CAIRO_FONT_WEIGHT_NORMAL);
   for (int i = 0; i <= 5; i++) {
-    double val = max_time * (1.0 - i / 5.0);
+    double val = max_val * (1.0 - i / 5.0);
     char buf[32];
-    snprintf(buf, 32, "%.0f", val);
+    chart_format_value(buf, sizeof(buf), val, metric);
     cairo_text_extents(cr, buf, &ext);
     cairo_move_to(cr, margin - ext.width - 5,
                   margin + i * (graph_h / 5) + ext.height / 2);
@@ -748,77 +1451,64 @@ static void draw_chart(cairo_t *cr, double w, double h) {
   double legend_x = margin + 20;
   double legend_y = margin + 10;
   cairo_set_source_rgb(cr, 1, 1, 1);
-  cairo_rectangle(cr, legend_x - 5, legend_y - 5, 100, 4 * 20 + 10);
+  cairo_rectangle(cr, legend_x - 5, legend_y - 5, 100, nb_active * 20 + 10);
   cairo_fill_preserve(cr);
   cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);
   cairo_set_line_width(cr, 1.0);
   cairo_stroke(cr);
 
-  for (int b = 0; b < 4; b++) {
-    gdk_cairo_set_source_rgba(cr, &benches[b]->color);
+  int row = 0;
+  for (int b = 0; b < NB_ALGOS; b++) {
+    if (!benches[b].active)
+      continue;
+    gdk_cairo_set_source_rgba(cr, &benches[b].color);
     cairo_set_line_width(cr, 2.5);
     cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
-    for (int i = 0; i < MAX_POINTS; i++) {
+    cairo_new_path(cr);
+    for (int i = 0; i < benches[b].nb_points; i++) {
+      if (chart_metric_value(&benches[b].results[i], metric, &v) != 0)
+        continue;
       double x = margin + (i * (graph_w / (MAX_POINTS - 1)));
-      double y =
-          (margin + graph_h) - (benches[b]->times[i] / max_time * graph_h);
-      if (i == 0)
-        cairo_move_to(cr, x, y);
-      else
-        cairo_line_to(cr, x, y);
+      double y = (margin + graph_h) - (v / max_val * graph_h);
+      cairo_line_to(cr, x, y); // Moves to the first point
     }
     cairo_stroke(cr);
 
-    for (int i = 0; i < MAX_POINTS; i++) {
+    cairo_set_line_width(cr, 1.5);
+    for (int i = 0; i < benches[b].nb_points; i++) {
+      const BenchResult *r = &benches[b].results[i];
+      if (chart_metric_value(r, metric, &v) != 0)
+        continue;
       double x = margin + (i * (graph_w / (MAX_POINTS - 1)));
-      double y =
-          (margin + graph_h) - (benches[b]->times[i] / max_time * graph_h);
-      cairo_new_path(cr);
-      if (benches[b]->marker_type == 0)
-        cairo_arc(cr, x, y, 3, 0, 2 * G_PI);
-      else if (benches[b]->marker_type == 1)
-        cairo_rectangle(cr, x - 3, y - 3, 6, 6);
-      else if (benches[b]->marker_type == 2) {
-        cairo_move_to(cr, x, y - 4);
-        cairo_line_to(cr, x + 3, y + 3);
-        cairo_line_to(cr, x - 3, y + 3);
-        cairo_close_path(cr);
-      } else {
-        cairo_move_to(cr, x, y - 4);
-        cairo_line_to(cr, x + 3, y);
-        cairo_line_to(cr, x, y + 4);
-        cairo_line_to(cr, x - 3, y);
-        cairo_close_path(cr);
+      double y = (margin + graph_h) - (v / max_val * graph_h);
+      // Error bar: fastest run to 95th percentile
+      double y_lo = (margin + graph_h) - (r->min / max_val * graph_h);
+      double y_hi = (margin + graph_h) - (r->p95 / max_val * graph_h);
+      if (metric == METRIC_TIME && y_lo - y_hi > 1.0) {
+        cairo_set_line_width(cr, 1.0);
+        cairo_move_to(cr, x, y_lo);
+        cairo_line_to(cr, x, y_hi);
+        cairo_move_to(cr, x - 3, y_lo);
+        cairo_line_to(cr, x + 3, y_lo);
+        cairo_move_to(cr, x - 3, y_hi);
+        cairo_line_to(cr, x + 3, y_hi);
+        cairo_stroke(cr);
+        cairo_set_line_width(cr, 1.5);
       }
-      cairo_fill(cr);
+      draw_marker(cr, benches[b].marker_type, x, y);
     }
-    double ly = legend_y + b * 20 + 10;
+    double ly = legend_y + row * 20 + 10;
+    row++;
+    cairo_set_line_width(cr, 2.5);
     cairo_move_to(cr, legend_x, ly);
     cairo_line_to(cr, legend_x + 20, ly);
     cairo_stroke(cr);
 
-    cairo_new_path(cr);
-    double mx = legend_x + 10;
-    if (benches[b]->marker_type == 0)
-      cairo_arc(cr, mx, ly, 3, 0, 2 * G_PI);
-    else if (benches[b]->marker_type == 1)
-      cairo_rectangle(cr, mx - 3, ly - 3, 6, 6);
-    else if (benches[b]->marker_type == 2) {
-      cairo_move_to(cr, mx, ly - 4);
-      cairo_line_to(cr, mx + 3, ly + 3);
-      cairo_line_to(cr, mx - 3, ly + 3);
-      cairo_close_path(cr);
-    } else {
-      cairo_move_to(cr, mx, ly - 4);
-      cairo_line_to(cr, mx + 3, ly);
-      cairo_line_to(cr, mx, ly + 4);
-      cairo_line_to(cr, mx - 3, ly);
-      cairo_close_path(cr);
-    }
-    cairo_fill(cr);
+    cairo_set_line_width(cr, 1.5);
+    draw_marker(cr, benches[b].marker_type, legend_x + 10, ly);
     cairo_set_source_rgb(cr, 0, 0, 0);
     cairo_move_to(cr, legend_x + 25, ly + 4);
-    cairo_show_text(cr, benches[b]->name);
+    cairo_show_text(cr, benches[b].name);
   }
 
   cairo_set_source_rgb(cr, 0, 0, 0);
@@ -832,6 +1522,10 @@ static void draw_chart(cairo_t *cr, double w, double h) {
   }
 }
 
+static void on_metric_changed(GtkComboBox *combo, gpointer data) {
+  gtk_widget_queue_draw(widgets_sort->drawing_area);
+}
+
 static gboolean on_draw_area(GtkWidget *widget, cairo_t *cr, gpointer data) {
   guint w = gtk_widget_get_allocated_width(widget);
   guint h = gtk_widget_get_allocated_height(widget);
@@ -846,21 +1540,41 @@ static gboolean on_draw_area(GtkWidget *widget, cairo_t *cr, gpointer data) {
 GtkWidget *create_tab_sort(void) {
   widgets_sort = malloc(sizeof(TabSortWidgets));
   widgets_sort->array = NULL;
+  widgets_sort->sorted = NULL;
   widgets_sort->size = 0;
   widgets_sort->current_type = TYPE_INT;
-
-  gdk_rgba_parse(&widgets_sort->bench_bulle.color, "#D9534F");
-  widgets_sort->bench_bulle.name = "Bulle";
-  widgets_sort->bench_bulle.marker_type = 0;
-  gdk_rgba_parse(&widgets_sort->bench_insertion.color, "#F0AD4E");
-  widgets_sort->bench_insertion.name = "Insertion";
-  widgets_sort->bench_insertion.marker_type = 1;
-  gdk_rgba_parse(&widgets_sort->bench_shell.color, "#A569BD");
-  widgets_sort->bench_shell.name = "Shell";
-  widgets_sort->bench_shell.marker_type = 2;
-  gdk_rgba_parse(&widgets_sort->bench_quick.color, "#5CB85C");
-  widgets_sort->bench_quick.name = "Rapide";
-  widgets_sort->bench_quick.marker_type = 3;
+  string_arena_init(&widgets_sort->strings);
+  memset(&widgets_sort->mapped, 0, sizeof(widgets_sort->mapped));
+  widgets_sort->has_bench_data = 0;
+  widgets_sort->compare_cancel = NULL;
+  widgets_sort->compare_job = NULL;
+  widgets_sort->compare_generation = 0;
+  widgets_sort->load_generation = 0;
+  widgets_sort->trace_values = NULL;
+  widgets_sort->has_trace = 0;
+  widgets_sort->replay_timer = 0;
+  widgets_sort->replay_updating = 0;
+
+  static const struct {
+    const char *color, *name;
+  } series[NB_ALGOS] = {
+      [ALGO_BUBBLE] = {"#D9534F", "Bulle"},
+      [ALGO_INSERTION] = {"#F0AD4E", "Insertion"},
+      [ALGO_SHELL] = {"#A569BD", "Shell"},
+      [ALGO_QUICK] = {"#5CB85C", "Rapide"},
+      [ALGO_RADIX] = {"#17A2B8", "Radix"},
+      [ALGO_PAR_QUICK] = {"#343A40", "Rapide //"},
+      [ALGO_PAR_MERGE] = {"#E83E8C", "Fusion //"},
+      [ALGO_MULTIKEY] = {"#6F4E37", "Multiclé"},
+      [ALGO_NATURAL] = {"#007BFF", "Naturel"},
+      [ALGO_PREFIX] = {"#20C997", "Préfixes"},
+  };
+  for (int b = 0; b < NB_ALGOS; b++) {
+    gdk_rgba_parse(&widgets_sort->benches[b].color, series[b].color);
+    widgets_sort->benches[b].name = series[b].name;
+    widgets_sort->benches[b].marker_type = b; // One shape per series
+    widgets_sort->benches[b].nb_points = 0;
+  }
 
   GtkWidget *main_paned = gtk_paned_new(GTK_ORIENTATION_HORIZONTAL);
   gtk_container_set_border_width(GTK_CONTAINER(main_paned), 10);
@@ -914,6 +1628,23 @@ GtkWidget *create_tab_sort(void) {
   gtk_box_pack_start(GTK_BOX(box_conf), widgets_sort->entry_size, FALSE, FALSE,
                      0);
 
+  // Distribution of the generated data
+  widgets_sort->combo_dist = gtk_combo_box_text_new();
+  for (int d = 0; d < DIST_COUNT; d++)
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(widgets_sort->combo_dist),
+                                   DIST_LABELS[d]);
+  widgets_sort->entry_dist_param = gtk_entry_new();
+  g_signal_connect(widgets_sort->combo_dist, "changed",
+                   G_CALLBACK(on_dist_changed), NULL);
+  gtk_combo_box_set_active(GTK_COMBO_BOX(widgets_sort->combo_dist),
+                           DIST_RANDOM);
+  GtkWidget *box_dist = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  gtk_box_pack_start(GTK_BOX(box_dist), widgets_sort->combo_dist, TRUE, TRUE,
+                     0);
+  gtk_box_pack_start(GTK_BOX(box_dist), widgets_sort->entry_dist_param, TRUE,
+                     TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_conf), box_dist, FALSE, FALSE, 0);
+
   // Manual Input (Single Value)
   widgets_sort->box_manual_input = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
 
@@ -957,6 +1688,22 @@ GtkWidget *create_tab_sort(void) {
   gtk_box_pack_start(GTK_BOX(box_p), btn_l, TRUE, TRUE, 0);
   gtk_box_pack_start(GTK_BOX(box_conf), box_p, FALSE, FALSE, 0);
 
+  GtkWidget *box_ext = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  GtkWidget *btn_ext = gtk_button_new_with_label("Tri externe (fichier)");
+  style_button(btn_ext, "#6c757d");
+  g_signal_connect(btn_ext, "clicked", G_CALLBACK(on_external_sort), NULL);
+  widgets_sort->entry_ext_mem = gtk_entry_new();
+  gtk_entry_set_placeholder_text(GTK_ENTRY(widgets_sort->entry_ext_mem),
+                                 "Mémoire (Mo)");
+  gtk_entry_set_width_chars(GTK_ENTRY(widgets_sort->entry_ext_mem), 8);
+  gtk_box_pack_start(GTK_BOX(box_ext), btn_ext, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_ext), widgets_sort->entry_ext_mem, FALSE,
+                     FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_conf), box_ext, FALSE, FALSE, 0);
+  widgets_sort->progress_ext = gtk_progress_bar_new();
+  gtk_box_pack_start(GTK_BOX(box_conf), widgets_sort->progress_ext, FALSE,
+                     FALSE, 0);
+
   gtk_box_pack_start(GTK_BOX(sidebar), frame_conf, FALSE, FALSE, 0);
 
   // Algos
@@ -981,10 +1728,95 @@ GtkWidget *create_tab_sort(void) {
   g_signal_connect(btn4, "clicked", G_CALLBACK(on_sort_quick), NULL);
   gtk_box_pack_start(GTK_BOX(box_al), btn4, FALSE, FALSE, 0);
 
+  GtkWidget *btn5 = gtk_button_new_with_label("Tri Radix");
+  g_signal_connect(btn5, "clicked", G_CALLBACK(on_sort_radix), NULL);
+  gtk_box_pack_start(GTK_BOX(box_al), btn5, FALSE, FALSE, 0);
+
+  GtkWidget *btn8 = gtk_button_new_with_label("Tri Multiclé (chaînes)");
+  g_signal_connect(btn8, "clicked", G_CALLBACK(on_sort_multikey), NULL);
+  gtk_box_pack_start(GTK_BOX(box_al), btn8, FALSE, FALSE, 0);
+
+  GtkWidget *btn10 = gtk_button_new_with_label("Tri Préfixes (chaînes)");
+  g_signal_connect(btn10, "clicked", G_CALLBACK(on_sort_prefix), NULL);
+  gtk_box_pack_start(GTK_BOX(box_al), btn10, FALSE, FALSE, 0);
+
+  widgets_sort->check_trace =
+      gtk_check_button_new_with_label("Enregistrer l'animation");
+  gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widgets_sort->check_trace),
+                               TRUE);
+  gtk_widget_set_tooltip_text(widgets_sort->check_trace,
+                              "Bulle, Insertion, Shell et Rapide");
+  gtk_box_pack_start(GTK_BOX(box_al), widgets_sort->check_trace, FALSE, FALSE,
+                     0);
+
+  GtkWidget *btn9 = gtk_button_new_with_label("Tri Fusion Naturel");
+  g_signal_connect(btn9, "clicked", G_CALLBACK(on_sort_natural), NULL);
+  gtk_box_pack_start(GTK_BOX(box_al), btn9, FALSE, FALSE, 0);
+
+  // Selection: k-th element, k smallest sorted, k largest
+  GtkWidget *box_sel = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  widgets_sort->entry_k = gtk_entry_new();
+  gtk_entry_set_placeholder_text(GTK_ENTRY(widgets_sort->entry_k), "k");
+  gtk_entry_set_width_chars(GTK_ENTRY(widgets_sort->entry_k), 6);
+  gtk_widget_set_tooltip_text(widgets_sort->entry_k,
+                              "Rang (défaut : la médiane) ou nombre "
+                              "d'éléments (défaut : 100)");
+  GtkWidget *btn_nth = gtk_button_new_with_label("k-ième");
+  g_signal_connect(btn_nth, "clicked", G_CALLBACK(on_select_nth), NULL);
+  GtkWidget *btn_partial = gtk_button_new_with_label("Partiel");
+  gtk_widget_set_tooltip_text(btn_partial, "Les k plus petits, triés");
+  g_signal_connect(btn_partial, "clicked", G_CALLBACK(on_select_partial),
+                   NULL);
+  GtkWidget *btn_top = gtk_button_new_with_label("Top-k");
+  gtk_widget_set_tooltip_text(btn_top, "Les k plus grands, décroissants");
+  g_signal_connect(btn_top, "clicked", G_CALLBACK(on_select_top_k), NULL);
+  gtk_box_pack_start(GTK_BOX(box_sel), widgets_sort->entry_k, FALSE, FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_sel), btn_nth, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_sel), btn_partial, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_sel), btn_top, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_al), box_sel, FALSE, FALSE, 0);
+
+  // Parallel sorts + tuning
+  GtkWidget *box_par = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  GtkWidget *btn6 = gtk_button_new_with_label("Rapide //");
+  g_signal_connect(btn6, "clicked", G_CALLBACK(on_sort_par_quick), NULL);
+  GtkWidget *btn7 = gtk_button_new_with_label("Fusion //");
+  g_signal_connect(btn7, "clicked", G_CALLBACK(on_sort_par_merge), NULL);
+  gtk_box_pack_start(GTK_BOX(box_par), btn6, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_par), btn7, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_al), box_par, FALSE, FALSE, 0);
+
+  GtkWidget *box_tune = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  widgets_sort->entry_threads = gtk_entry_new();
+  gtk_entry_set_placeholder_text(GTK_ENTRY(widgets_sort->entry_threads),
+                                 "Threads (auto)");
+  widgets_sort->entry_cutoff = gtk_entry_new();
+  gtk_entry_set_placeholder_text(GTK_ENTRY(widgets_sort->entry_cutoff),
+                                 "Seuil séquentiel");
+  gtk_box_pack_start(GTK_BOX(box_tune), widgets_sort->entry_threads, TRUE,
+                     TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_tune), widgets_sort->entry_cutoff, TRUE, TRUE,
+                     0);
+  gtk_box_pack_start(GTK_BOX(box_al), box_tune, FALSE, FALSE, 0);
+
+  GtkWidget *box_cmp = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
   GtkWidget *btn_cmp = gtk_button_new_with_label("Comparer Tout");
   style_button(btn_cmp, "#28A745");
   g_signal_connect(btn_cmp, "clicked", G_CALLBACK(on_compare_all), NULL);
-  gtk_box_pack_start(GTK_BOX(box_al), btn_cmp, FALSE, FALSE, 10);
+  GtkWidget *btn_cancel = gtk_button_new_with_label("Annuler");
+  style_button(btn_cancel, "#D9534F");
+  g_signal_connect(btn_cancel, "clicked", G_CALLBACK(on_cancel_compare), NULL);
+  gtk_widget_set_sensitive(btn_cancel, FALSE);
+  gtk_box_pack_start(GTK_BOX(box_cmp), btn_cmp, TRUE, TRUE, 0);
+  gtk_box_pack_start(GTK_BOX(box_cmp), btn_cancel, FALSE, FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_al), box_cmp, FALSE, FALSE, 10);
+  widgets_sort->btn_compare = btn_cmp;
+  widgets_sort->btn_cancel_cmp = btn_cancel;
+  widgets_sort->progress_cmp = gtk_progress_bar_new();
+  gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(widgets_sort->progress_cmp),
+                                 TRUE);
+  gtk_box_pack_start(GTK_BOX(box_al), widgets_sort->progress_cmp, FALSE, FALSE,
+                     0);
 
   gtk_box_pack_start(GTK_BOX(sidebar), frame_al, FALSE, FALSE, 0);
   gtk_paned_add1(GTK_PANED(main_paned), sidebar);
@@ -992,31 +1824,79 @@ GtkWidget *create_tab_sort(void) {
   // Content
   GtkWidget *content = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
   GtkWidget *box_dat = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
-  gtk_widget_set_size_request(box_dat, -1, 150);
+  gtk_widget_set_size_request(box_dat, -1, 220);
 
   GtkWidget *fr_raw = gtk_frame_new("DONNÉES BRUTES");
-  GtkWidget *sc_raw = gtk_scrolled_window_new(NULL, NULL);
-  widgets_sort->text_raw = gtk_text_view_new();
-  gtk_text_view_set_editable(GTK_TEXT_VIEW(widgets_sort->text_raw), FALSE);
-  gtk_container_add(GTK_CONTAINER(sc_raw), widgets_sort->text_raw);
-  gtk_container_add(GTK_CONTAINER(fr_raw), sc_raw);
+  widgets_sort->view_raw = data_view_new();
+  gtk_container_add(GTK_CONTAINER(fr_raw),
+                    data_view_widget(widgets_sort->view_raw));
 
   GtkWidget *fr_sort = gtk_frame_new("RÉSULTAT TRIÉ");
-  GtkWidget *sc_sort = gtk_scrolled_window_new(NULL, NULL);
-  widgets_sort->text_sorted = gtk_text_view_new();
-  gtk_text_view_set_editable(GTK_TEXT_VIEW(widgets_sort->text_sorted), FALSE);
-  gtk_container_add(GTK_CONTAINER(sc_sort), widgets_sort->text_sorted);
-  gtk_container_add(GTK_CONTAINER(fr_sort), sc_sort);
+  widgets_sort->view_sorted = data_view_new();
+  gtk_container_add(GTK_CONTAINER(fr_sort),
+                    data_view_widget(widgets_sort->view_sorted));
 
   gtk_box_pack_start(GTK_BOX(box_dat), fr_raw, TRUE, TRUE, 0);
   gtk_box_pack_start(GTK_BOX(box_dat), fr_sort, TRUE, TRUE, 0);
   gtk_box_pack_start(GTK_BOX(content), box_dat, FALSE, FALSE, 0);
 
   GtkWidget *fr_vis = create_card("Visualisation");
+  GtkWidget *box_vis = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+  GtkWidget *box_metric = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  widgets_sort->combo_metric = chart_metric_combo();
+  g_signal_connect(widgets_sort->combo_metric, "changed",
+                   G_CALLBACK(on_metric_changed), NULL);
+  gtk_box_pack_start(GTK_BOX(box_metric), gtk_label_new("Axe Y :"), FALSE,
+                     FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_metric), widgets_sort->combo_metric, FALSE,
+                     FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_vis), box_metric, FALSE, FALSE, 0);
   widgets_sort->drawing_area = gtk_drawing_area_new();
   g_signal_connect(widgets_sort->drawing_area, "draw", G_CALLBACK(on_draw_area),
                    NULL);
-  gtk_container_add(GTK_CONTAINER(fr_vis), widgets_sort->drawing_area);
+  gtk_box_pack_start(GTK_BOX(box_vis), widgets_sort->drawing_area, TRUE, TRUE,
+                     0);
+
+  // Animation page: replay of the last traced run
+  GtkWidget *box_anim = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+  GtkWidget *box_ctl = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+  widgets_sort->btn_play = gtk_button_new_with_label("Lecture");
+  g_signal_connect(widgets_sort->btn_play, "clicked",
+                   G_CALLBACK(on_replay_play), NULL);
+  widgets_sort->scale_speed =
+      gtk_scale_new_with_range(GTK_ORIENTATION_HORIZONTAL, 0, 7, 0.1);
+  gtk_range_set_value(GTK_RANGE(widgets_sort->scale_speed), 1);
+  gtk_scale_set_draw_value(GTK_SCALE(widgets_sort->scale_speed), FALSE);
+  gtk_widget_set_size_request(widgets_sort->scale_speed, 150, -1);
+  widgets_sort->label_replay = gtk_label_new("Aucune trace");
+  gtk_box_pack_start(GTK_BOX(box_ctl), widgets_sort->btn_play, FALSE, FALSE,
+                     0);
+  gtk_box_pack_start(GTK_BOX(box_ctl), gtk_label_new("Vitesse :"), FALSE,
+                     FALSE, 0);
+  gtk_box_pack_start(GTK_BOX(box_ctl), widgets_sort->scale_speed, FALSE, FALSE,
+                     0);
+  gtk_box_pack_start(GTK_BOX(box_ctl), widgets_sort->label_replay, FALSE,
+                     FALSE, 5);
+  gtk_box_pack_start(GTK_BOX(box_anim), box_ctl, FALSE, FALSE, 0);
+  widgets_sort->scale_pos =
+      gtk_scale_new_with_range(GTK_ORIENTATION_HORIZONTAL, 0, 1, 1);
+  gtk_scale_set_draw_value(GTK_SCALE(widgets_sort->scale_pos), FALSE);
+  g_signal_connect(widgets_sort->scale_pos, "value-changed",
+                   G_CALLBACK(on_replay_seek), NULL);
+  gtk_box_pack_start(GTK_BOX(box_anim), widgets_sort->scale_pos, FALSE, FALSE,
+                     0);
+  widgets_sort->area_replay = gtk_drawing_area_new();
+  g_signal_connect(widgets_sort->area_replay, "draw",
+                   G_CALLBACK(on_draw_replay), NULL);
+  gtk_box_pack_start(GTK_BOX(box_anim), widgets_sort->area_replay, TRUE, TRUE,
+                     0);
+
+  GtkWidget *notebook_vis = gtk_notebook_new();
+  gtk_notebook_append_page(GTK_NOTEBOOK(notebook_vis), box_vis,
+                           gtk_label_new("Courbes"));
+  gtk_notebook_append_page(GTK_NOTEBOOK(notebook_vis), box_anim,
+                           gtk_label_new("Animation"));
+  gtk_container_add(GTK_CONTAINER(fr_vis), notebook_vis);
   gtk_box_pack_start(GTK_BOX(content), fr_vis, TRUE, TRUE, 0);
 
   gtk_paned_add2(GTK_PANED(main_paned), content);